@@ -0,0 +1,602 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "apu.h"
+#include "gameboy.h"
+#include "hash.h"
+#include "timeline.h"
+#include "wav.h"
+
+// The kernel add in blip_add_delta is done with the widest vectors the
+// compiler was told it may use.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BLIP_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BLIP_SSE2
+#endif
+
+// From gameboy.cpp.
+extern uint8_t memory[65536];
+extern long int cycle_count;
+extern uint64_t emulated_cycles;
+
+SpscQueue<audio_sample, 4096> audio_queue;
+bool audio_output_enabled = false;
+bool audio_hashes_enabled = false;
+std::vector<uint64_t> audio_hashes;
+
+// Dynamic rate control. The front end plays samples on the sound card's
+// clock and the core makes them on the steady_clock, so the queue slowly
+// fills up or runs dry. Instead the output rate is nudged by up to 0.5% to
+// hold what is left in the queue, just before each frame is pushed, at
+// AUDIO_TARGET_FILL. A frame adds about 800 samples on top, so on average
+// the queue holds around 18 ms and with the front end's 512 sample device
+// buffer the total latency stays under 30 ms.
+const int AUDIO_TARGET_FILL = AUDIO_SAMPLE_RATE * 10 / 1000;
+const double AUDIO_MAX_RATE_ADJUST = 0.005;
+const double AUDIO_RATE_GAIN = 0.005;       // Rate adjustment for a fill error of AUDIO_TARGET_FILL.
+const double AUDIO_RATE_INTEGRAL = 0.0001;  // Per frame, takes out the steady clock drift.
+const double AUDIO_FILL_SMOOTHING = 0.1;    // Weight of the newest frame in the fill average.
+double audio_fill_average = AUDIO_TARGET_FILL;
+double audio_rate_drift = 0;                // Integral of the fill error.
+
+std::atomic<int> audio_fill(0);
+std::atomic<int> audio_rate_ppm(0);
+std::atomic<uint32_t> audio_underruns(0);
+std::atomic<uint32_t> audio_overruns(0);
+
+// Band-limited step synthesis. Every change of the mixed output level adds
+// a windowed sinc step to a buffer of differences at the exact (fractional)
+// sample position it happened at. Reading the buffer out sums the
+// differences back up, with a small leak to remove DC.
+const double PI = 3.14159265358979323846;
+const int BLIP_PHASES = 32;       // Sub-sample positions a step can start at.
+const int BLIP_PHASE_BITS = 5;
+const int BLIP_WIDTH = 16;        // Samples each step is spread over.
+const int BLIP_KERNEL_BITS = 14;  // Each phase of the kernel adds up to 1 << BLIP_KERNEL_BITS.
+const int BLIP_BASS_SHIFT = 9;    // High pass, about 15 Hz at 48 kHz.
+const int BLIP_SIZE = 2048;       // More than a frame of samples.
+
+int16_t blip_kernel[BLIP_PHASES][BLIP_WIDTH];
+int32_t blip_deltas[2][BLIP_SIZE + BLIP_WIDTH];  // Left, right.
+int32_t blip_integrator[2];
+audio_sample blip_samples[BLIP_SIZE];            // One frame of output, pushed in one go.
+uint64_t blip_factor;                            // Output samples per cycle, 32.32 fixed point.
+uint64_t blip_offset;                            // Buffer position of the start of the frame, fraction only.
+
+// Mixer.
+const int APU_VOLUME_UNIT = 64;  // All four channels at 15 and NR50 at 7 comes to 30720, so steps fit in 16 bits.
+int mix_left = 0;
+int mix_right = 0;
+
+// Channels. 0 and 1 are the squares, 2 the wave and 3 the noise channel.
+// Times are in cycles since the start of the frame.
+struct apu_channel {
+	bool enabled;         // Bit in NR52. Cleared when the length runs out or the DAC is off.
+	bool dac;             // DAC powered (NRx2 top five bits, NR30 bit 7).
+	int length;           // Counts down while NRx4 bit 6 is set, the channel stops at 0.
+	int volume;           // Envelope volume 0-15. Not used by the wave channel.
+	int envelope_timer;   // Sequencer envelope clocks until the next volume step.
+	uint32_t period;      // Cycles between steps of the channel timer.
+	uint32_t next_step;   // Time of the next step.
+	int position;         // Duty step (0-7) or wave sample (0-31).
+};
+apu_channel channels[4];
+
+const uint8_t duty_table[4][8] = {
+	{ 0, 0, 0, 0, 0, 0, 0, 1 },  // 12.5%
+	{ 1, 0, 0, 0, 0, 0, 0, 1 },  // 25%
+	{ 1, 0, 0, 0, 0, 1, 1, 1 },  // 50%
+	{ 0, 1, 1, 1, 1, 1, 1, 0 },  // 75%
+};
+
+// Bits that always read back as 1, for 0xFF10-0xFF2F.
+const uint8_t read_masks[0x20] = {
+	0x80, 0x3F, 0x00, 0xFF, 0xBF,  // NR10-NR14
+	0xFF, 0x3F, 0x00, 0xFF, 0xBF,  // NR20-NR24
+	0x7F, 0xFF, 0x9F, 0xFF, 0xBF,  // NR30-NR34
+	0xFF, 0xFF, 0x00, 0x00, 0xBF,  // NR40-NR44
+	0x00, 0x00, 0x70,              // NR50-NR52
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+bool apu_power = false;       // NR52 bit 7.
+uint32_t apu_time = 0;        // How far the channels have been run.
+uint32_t next_sequencer = 8192;
+int sequencer_step = 0;       // 512 Hz frame sequencer, 0-7.
+
+// Square 1 frequency sweep.
+bool sweep_enabled = false;
+int sweep_timer = 0;
+int sweep_shadow = 0;  // Frequency the sweep works from.
+
+uint16_t lfsr = 0x7FFF;  // Noise shift register.
+
+void run_apu(uint32_t until);    // Runs the channels and sequencer up to until.
+void step_channel(int channel);  // Steps the channel timer's duty, wave or noise position.
+void clock_sequencer();          // Clocks length, sweep and envelope as the step calls for.
+void clock_length(int channel);
+void clock_envelope(int channel);
+void clock_sweep();
+int sweep_frequency();  // Next sweep frequency. Stops square 1 if it overflows.
+void trigger_channel(int channel);
+void set_dac(int channel, bool on);
+void set_apu_power(bool on);
+int channel_frequency(int channel);      // 11 bit frequency from NRx3 and NRx4.
+uint32_t channel_period(int channel);    // Cycles between timer steps.
+int channel_level(int channel);          // Current digital output, 0-15.
+void update_mix(uint32_t time);          // Adds a step to the output if the mixed level changed.
+void adjust_audio_rate();                // Sets blip_factor to the rate that holds audio_queue at AUDIO_TARGET_FILL.
+void blip_add_delta(uint32_t time, int left, int right);
+void blip_add_kernel(int32_t* out, const int16_t* kernel, int delta);  // out[i] += kernel[i] * delta for the kernel width.
+int16_t blip_read(int side, int index);  // Sums up one output sample.
+
+void setup_apu() {
+	const double cutoff = 0.45;  // Fraction of the sample rate, a little under Nyquist.
+
+	for (int phase = 0; phase < BLIP_PHASES; phase++) {
+		double taps[BLIP_WIDTH];
+		double sum = 0;
+		for (int i = 0; i < BLIP_WIDTH; i++) {
+			double x = i - BLIP_WIDTH / 2 - (double)phase / BLIP_PHASES;
+			double sinc = x == 0 ? 1 : sin(2 * PI * cutoff * x) / (2 * PI * cutoff * x);
+			double w = (i + 1 - (double)phase / BLIP_PHASES) / (BLIP_WIDTH + 1);
+			double window = 0.42 - 0.5 * cos(2 * PI * w) + 0.08 * cos(4 * PI * w);  // Blackman
+			taps[i] = sinc * window;
+			sum += taps[i];
+		}
+
+		// Each phase must add up to exactly one step, or the output drifts.
+		int total = 0;
+		for (int i = 0; i < BLIP_WIDTH; i++) {
+			blip_kernel[phase][i] = (int16_t)floor(taps[i] / sum * (1 << BLIP_KERNEL_BITS) + 0.5);
+			total += blip_kernel[phase][i];
+		}
+		blip_kernel[phase][BLIP_WIDTH / 2] += (1 << BLIP_KERNEL_BITS) - total;
+	}
+
+	blip_factor = ((uint64_t)AUDIO_SAMPLE_RATE << 32) / CLOCKSPEED;
+}
+
+uint8_t read_apu(uint16_t location) {
+	if (location >= 0xFF30) {
+		return memory[location];
+	}
+
+	if (location == 0xFF26) {
+		run_apu(cycle_count);
+		uint8_t status = memory[0xFF26] | read_masks[0x16];
+		for (int i = 0; i < 4; i++) {
+			if (channels[i].enabled) {
+				status |= 1 << i;
+			}
+		}
+		return status;
+	}
+
+	return memory[location] | read_masks[location - 0xFF10];
+}
+
+void write_apu(uint8_t data, uint16_t location) {
+	run_apu(cycle_count);
+
+	// Wave RAM
+	if (location >= 0xFF30) {
+		memory[location] = data;
+		return;
+	}
+
+	if (location == 0xFF26) {
+		set_apu_power(data & 0x80);
+		return;
+	}
+
+	// Everything else is read only while the APU is off.
+	if (!apu_power) {
+		return;
+	}
+	memory[location] = data;
+
+	// NR50, NR51 and the unused registers after them.
+	if (location >= 0xFF24) {
+		update_mix(apu_time);
+		return;
+	}
+
+	int channel = (location - 0xFF10) / 5;
+	switch ((location - 0xFF10) % 5) {
+	case 0:
+		if (channel == 2) {
+			set_dac(channel, data & 0x80);
+		}
+		break;
+	case 1:
+		channels[channel].length = channel == 2 ? 256 - data : 64 - (data & 0x3F);
+		break;
+	case 2:
+		if (channel != 2) {
+			set_dac(channel, data & 0xF8);
+		}
+		break;
+	case 3:
+		channels[channel].period = channel_period(channel);
+		break;
+	case 4:
+		channels[channel].period = channel_period(channel);
+		if (data & 0x80) {
+			trigger_channel(channel);
+		}
+		break;
+	}
+
+	update_mix(apu_time);
+}
+
+void end_apu_frame() {
+	TIMELINE_SCOPE("end_apu_frame");
+	uint32_t frame_end = cycle_count;
+	run_apu(frame_end);
+
+	// Read out every whole sample up to the end of the frame.
+	uint64_t end = blip_offset + frame_end * blip_factor;
+	int count = (int)(end >> 32);
+	for (int i = 0; i < count; i++) {
+		blip_samples[i].left = blip_read(0, i);
+		blip_samples[i].right = blip_read(1, i);
+	}
+	if (wav_enabled) {
+		wav_samples(blip_samples, count);
+	}
+	if (audio_hashes_enabled) {
+		audio_hashes.push_back(xxhash64(blip_samples, count * sizeof(audio_sample)));
+	}
+	if (audio_output_enabled) {
+		adjust_audio_rate();
+		size_t pushed = audio_queue.push(blip_samples, count);
+		if (pushed < (size_t)count) {
+			audio_overruns += count - (uint32_t)pushed;
+		}
+	}
+
+	// Keep the tails of steps that reach past the end for the next frame.
+	for (int side = 0; side < 2; side++) {
+		memmove(blip_deltas[side], blip_deltas[side] + count, BLIP_WIDTH * sizeof(int32_t));
+		memset(blip_deltas[side] + BLIP_WIDTH, 0, count * sizeof(int32_t));
+	}
+	blip_offset = end & 0xFFFFFFFF;
+
+	// The next frame starts again from cycle 0.
+	apu_time -= frame_end;
+	next_sequencer -= frame_end;
+	for (int i = 0; i < 4; i++) {
+		channels[i].next_step = channels[i].enabled ? channels[i].next_step - frame_end : 0;
+	}
+}
+
+void adjust_audio_rate() {
+	int fill = (int)audio_queue.size();
+	audio_fill = fill;
+	audio_fill_average += (fill - audio_fill_average) * AUDIO_FILL_SMOOTHING;
+
+	double error = (AUDIO_TARGET_FILL - audio_fill_average) / AUDIO_TARGET_FILL;
+	audio_rate_drift += error * AUDIO_RATE_INTEGRAL;
+	audio_rate_drift = fmax(-AUDIO_MAX_RATE_ADJUST, fmin(AUDIO_MAX_RATE_ADJUST, audio_rate_drift));
+	double adjust = error * AUDIO_RATE_GAIN + audio_rate_drift;
+	adjust = fmax(-AUDIO_MAX_RATE_ADJUST, fmin(AUDIO_MAX_RATE_ADJUST, adjust));
+
+	// Only ever changed between frames, positions within a frame all use the same factor.
+	blip_factor = (uint64_t)((1 + adjust) * AUDIO_SAMPLE_RATE * 4294967296.0 / CLOCKSPEED);
+	audio_rate_ppm = (int)(adjust * 1000000);
+}
+
+void run_apu(uint32_t until) {
+	while (apu_time < until) {
+		// Jump straight to whichever happens first.
+		uint32_t next = until;
+		if (next_sequencer < next) {
+			next = next_sequencer;
+		}
+		for (int i = 0; i < 4; i++) {
+			if (channels[i].enabled && channels[i].next_step < next) {
+				next = channels[i].next_step;
+			}
+		}
+		apu_time = next;
+
+		if (apu_time == next_sequencer) {
+			clock_sequencer();
+			next_sequencer += 8192;
+		}
+		for (int i = 0; i < 4; i++) {
+			if (channels[i].enabled && channels[i].next_step == apu_time) {
+				step_channel(i);
+				channels[i].next_step += channels[i].period;
+			}
+		}
+
+		update_mix(apu_time);
+	}
+}
+
+void step_channel(int channel) {
+	switch (channel) {
+	case 0:
+	case 1:
+		channels[channel].position = (channels[channel].position + 1) & 7;
+		break;
+	case 2:
+		channels[channel].position = (channels[channel].position + 1) & 31;
+		break;
+	case 3: {
+		uint16_t bit = (lfsr ^ (lfsr >> 1)) & 1;
+		lfsr = (lfsr >> 1) | (bit << 14);
+		// 7 bit mode.
+		if (memory[0xFF22] & 0x08) {
+			lfsr = (lfsr & ~0x40) | (bit << 6);
+		}
+		break;
+	}
+	}
+}
+
+void clock_sequencer() {
+	if (apu_power) {
+		if (!(sequencer_step & 1)) {
+			for (int i = 0; i < 4; i++) {
+				clock_length(i);
+			}
+		}
+		if (sequencer_step == 2 || sequencer_step == 6) {
+			clock_sweep();
+		}
+		if (sequencer_step == 7) {
+			clock_envelope(0);
+			clock_envelope(1);
+			clock_envelope(3);
+		}
+	}
+	sequencer_step = (sequencer_step + 1) & 7;
+}
+
+void clock_length(int channel) {
+	if ((memory[0xFF14 + channel * 5] & 0x40) && channels[channel].length > 0) {
+		channels[channel].length--;
+		if (channels[channel].length == 0) {
+			channels[channel].enabled = false;
+		}
+	}
+}
+
+void clock_envelope(int channel) {
+	uint8_t envelope = memory[0xFF12 + channel * 5];
+	int period = envelope & 7;
+	if (!period) {
+		return;
+	}
+
+	apu_channel& ch = channels[channel];
+	if (--ch.envelope_timer <= 0) {
+		ch.envelope_timer = period;
+		if (envelope & 0x08) {
+			if (ch.volume < 15) {
+				ch.volume++;
+			}
+		}
+		else if (ch.volume > 0) {
+			ch.volume--;
+		}
+	}
+}
+
+void clock_sweep() {
+	if (--sweep_timer > 0) {
+		return;
+	}
+
+	int period = (memory[0xFF10] >> 4) & 7;
+	sweep_timer = period ? period : 8;
+	if (!sweep_enabled || !period) {
+		return;
+	}
+
+	int frequency = sweep_frequency();
+	if (frequency <= 2047 && (memory[0xFF10] & 7)) {
+		sweep_shadow = frequency;
+		memory[0xFF13] = frequency & 0xFF;
+		memory[0xFF14] = (memory[0xFF14] & ~7) | (frequency >> 8);
+		channels[0].period = channel_period(0);
+
+		// Checked again straight away, only for the overflow.
+		sweep_frequency();
+	}
+}
+
+int sweep_frequency() {
+	int delta = sweep_shadow >> (memory[0xFF10] & 7);
+	int frequency = memory[0xFF10] & 0x08 ? sweep_shadow - delta : sweep_shadow + delta;
+	if (frequency > 2047) {
+		channels[0].enabled = false;
+	}
+	return frequency;
+}
+
+void trigger_channel(int channel) {
+	apu_channel& ch = channels[channel];
+	ch.enabled = ch.dac;
+	if (ch.length == 0) {
+		ch.length = channel == 2 ? 256 : 64;
+	}
+	ch.next_step = apu_time + ch.period;
+
+	uint8_t envelope = memory[0xFF12 + channel * 5];
+	ch.volume = envelope >> 4;
+	ch.envelope_timer = envelope & 7;
+
+	if (channel == 0) {
+		int period = (memory[0xFF10] >> 4) & 7;
+		int shift = memory[0xFF10] & 7;
+		sweep_shadow = channel_frequency(0);
+		sweep_timer = period ? period : 8;
+		sweep_enabled = period || shift;
+		if (shift) {
+			sweep_frequency();
+		}
+	}
+	else if (channel == 2) {
+		ch.position = 0;
+	}
+	else if (channel == 3) {
+		lfsr = 0x7FFF;
+	}
+}
+
+void set_dac(int channel, bool on) {
+	channels[channel].dac = on;
+	if (!on) {
+		channels[channel].enabled = false;
+	}
+}
+
+void set_apu_power(bool on) {
+	if (!on && apu_power) {
+		// Turning off clears every register up to NR51.
+		memset(memory + 0xFF10, 0, 0xFF26 - 0xFF10);
+		for (int i = 0; i < 4; i++) {
+			channels[i].enabled = false;
+			channels[i].dac = false;
+		}
+	}
+	else if (on && !apu_power) {
+		sequencer_step = 0;
+	}
+
+	apu_power = on;
+	memory[0xFF26] = on ? 0x80 : 0x00;
+	update_mix(apu_time);
+}
+
+int channel_frequency(int channel) {
+	return memory[0xFF13 + channel * 5] | ((memory[0xFF14 + channel * 5] & 7) << 8);
+}
+
+uint32_t channel_period(int channel) {
+	switch (channel) {
+	case 0:
+	case 1:
+		return (2048 - channel_frequency(channel)) * 4;
+	case 2:
+		return (2048 - channel_frequency(channel)) * 2;
+	default: {
+		uint8_t polynomial = memory[0xFF22];
+		int shift = polynomial >> 4;
+		// Shifts 14 and 15 stop the shift register altogether.
+		if (shift >= 14) {
+			return 0x40000000;
+		}
+		int divisor = (polynomial & 7) ? (polynomial & 7) * 16 : 8;
+		return divisor << shift;
+	}
+	}
+}
+
+int channel_level(int channel) {
+	const apu_channel& ch = channels[channel];
+	if (!ch.enabled) {
+		return 0;
+	}
+
+	switch (channel) {
+	case 0:
+	case 1:
+		return duty_table[memory[0xFF11 + channel * 5] >> 6][ch.position] ? ch.volume : 0;
+	case 2: {
+		uint8_t samples = memory[0xFF30 + ch.position / 2];
+		int sample = (ch.position & 1) ? samples & 0x0F : samples >> 4;
+		int volume = (memory[0xFF1C] >> 5) & 3;
+		return volume ? sample >> (volume - 1) : 0;
+	}
+	default:
+		return (lfsr & 1) ? 0 : ch.volume;
+	}
+}
+
+void update_mix(uint32_t time) {
+	uint8_t panning = memory[0xFF25];
+	int left = 0;
+	int right = 0;
+	for (int i = 0; i < 4; i++) {
+		int level = channel_level(i);
+		if (panning & (0x10 << i)) {
+			left += level;
+		}
+		if (panning & (0x01 << i)) {
+			right += level;
+		}
+	}
+	left *= (((memory[0xFF24] >> 4) & 7) + 1) * APU_VOLUME_UNIT;
+	right *= ((memory[0xFF24] & 7) + 1) * APU_VOLUME_UNIT;
+
+	if (left != mix_left || right != mix_right) {
+		blip_add_delta(time, left - mix_left, right - mix_right);
+		mix_left = left;
+		mix_right = right;
+	}
+}
+
+void blip_add_delta(uint32_t time, int left, int right) {
+	uint64_t position = blip_offset + time * blip_factor;
+	int index = (int)(position >> 32);
+	if (index >= BLIP_SIZE) {
+		return;
+	}
+
+	const int16_t* kernel = blip_kernel[(position >> (32 - BLIP_PHASE_BITS)) & (BLIP_PHASES - 1)];
+	blip_add_kernel(blip_deltas[0] + index, kernel, left);
+	blip_add_kernel(blip_deltas[1] + index, kernel, right);
+}
+
+void blip_add_kernel(int32_t* out, const int16_t* kernel, int delta) {
+#if defined(BLIP_AVX2)
+	__m256i scale = _mm256_set1_epi32(delta);
+	for (int i = 0; i < BLIP_WIDTH; i += 8) {
+		__m256i taps = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(kernel + i)));
+		__m256i sum = _mm256_add_epi32(_mm256_loadu_si256((__m256i*)(out + i)), _mm256_mullo_epi32(taps, scale));
+		_mm256_storeu_si256((__m256i*)(out + i), sum);
+	}
+#elif defined(BLIP_SSE2)
+	// No 32 bit multiply in SSE2, so 16 x 16 bit products are put together
+	// from their low and high halves.
+	__m128i scale = _mm_set1_epi16((int16_t)delta);
+	for (int i = 0; i < BLIP_WIDTH; i += 8) {
+		__m128i taps = _mm_loadu_si128((const __m128i*)(kernel + i));
+		__m128i low = _mm_mullo_epi16(taps, scale);
+		__m128i high = _mm_mulhi_epi16(taps, scale);
+		__m128i* dest = (__m128i*)(out + i);
+		_mm_storeu_si128(dest, _mm_add_epi32(_mm_loadu_si128(dest), _mm_unpacklo_epi16(low, high)));
+		_mm_storeu_si128(dest + 1, _mm_add_epi32(_mm_loadu_si128(dest + 1), _mm_unpackhi_epi16(low, high)));
+	}
+#else
+	for (int i = 0; i < BLIP_WIDTH; i++) {
+		out[i] += kernel[i] * delta;
+	}
+#endif
+}
+
+int16_t blip_read(int side, int index) {
+	int32_t& sum = blip_integrator[side];
+	sum += blip_deltas[side][index];
+
+	int32_t sample = sum >> BLIP_KERNEL_BITS;
+	sum -= sum >> BLIP_BASS_SHIFT;
+
+	if (sample > 32767) {
+		return 32767;
+	}
+	if (sample < -32768) {
+		return -32768;
+	}
+	return (int16_t)sample;
+}
@@ -0,0 +1,15 @@
+// Audio processing unit. Registers 0xFF10-0xFF3F are stored in memory like
+// the others, but the channels are only brought up to date when a register
+// is touched and at the end of each frame, not every instruction. Level
+// changes are added to the output as band-limited steps, so the sample rate
+// does not have to divide the clock and nothing aliases.
+#pragma once
+
+#include <stdint.h>
+
+uint8_t read_apu(uint16_t location);              // Read from 0xFF10-0xFF3F.
+void write_apu(uint8_t data, uint16_t location);  // Write to 0xFF10-0xFF3F.
+
+// Runs the channels to the end of the frame (cycle_count) and hands the
+// frame's samples to audio_queue, the WAV writer and audio_hashes.
+void end_apu_frame();
@@ -0,0 +1,175 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "callstack.h"
+#include "symbols.h"
+
+using namespace std;
+
+struct call_node {
+	int parent;                  // -1 for the top level.
+	uint32_t key;                // Callee as bank << 16 | address.
+	uint64_t cycles;             // Spent in this call path itself, not in its callees.
+	map<uint32_t, int> callees;  // Child nodes by key.
+};
+
+struct call_frame {
+	int node;
+	uint16_t return_address;
+	uint16_t sp;  // Before the return address was pushed.
+};
+
+bool call_stack_enabled = false;
+vector<call_node> call_nodes;    // Node 0 is the code outside any call.
+vector<call_frame> call_frames;  // The shadow stack, innermost last.
+uint64_t last_charge = 0;        // Emulated cycle up to which time has been charged.
+
+uint64_t returns_without_call = 0;
+uint64_t changed_returns = 0;
+uint64_t discarded_frames = 0;
+
+string call_stack_file;
+call_stack_format call_stack_type = CALL_STACK_FOLDED;
+
+void charge_cycles(uint64_t now);
+void discard_frames(uint16_t sp);  // Drops frames whose return address is no longer on the stack.
+string call_path(int node);        // "caller;callee" names from the top level down.
+
+void start_call_stack(const char* filename, call_stack_format format) {
+	call_stack_enabled = true;
+	call_stack_file = filename;
+	call_stack_type = format;
+	call_nodes.assign(1, call_node{ -1, 0, 0, map<uint32_t, int>() });
+	call_frames.clear();
+}
+
+void shadow_call(uint16_t return_address, uint16_t sp, uint16_t target, int target_bank, uint64_t now) {
+	charge_cycles(now);
+	discard_frames(sp);
+
+	int caller = call_frames.empty() ? 0 : call_frames.back().node;
+	uint32_t key = (target_bank < 0 ? 0xFF : target_bank) << 16 | target;
+	map<uint32_t, int>::const_iterator callee = call_nodes[caller].callees.find(key);
+	int node;
+	if (callee != call_nodes[caller].callees.end()) {
+		node = callee->second;
+	}
+	else {
+		node = (int)call_nodes.size();
+		call_nodes[caller].callees[key] = node;
+		call_nodes.push_back(call_node{ caller, key, 0, map<uint32_t, int>() });
+	}
+	call_frames.push_back(call_frame{ node, return_address, sp });
+}
+
+void shadow_return(uint16_t return_address, uint16_t sp, uint64_t now) {
+	charge_cycles(now);
+	discard_frames(sp);
+
+	if (call_frames.empty() || call_frames.back().sp != (uint16_t)(sp + 2)) {
+		returns_without_call++;
+		return;
+	}
+	if (call_frames.back().return_address != return_address) {
+		changed_returns++;
+	}
+	call_frames.pop_back();
+}
+
+void charge_cycles(uint64_t now) {
+	int node = call_frames.empty() ? 0 : call_frames.back().node;
+	call_nodes[node].cycles += now - last_charge;
+	last_charge = now;
+}
+
+void discard_frames(uint16_t sp) {
+	while (!call_frames.empty() && call_frames.back().sp <= sp) {
+		call_frames.pop_back();
+		discarded_frames++;
+	}
+}
+
+void write_call_stack(uint64_t now, int frames) {
+	charge_cycles(now);
+
+	bool to_stdout = call_stack_file == "-";
+	FILE* file = to_stdout ? stdout : fopen(call_stack_file.c_str(), "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", call_stack_file.c_str());
+		return;
+	}
+
+	if (call_stack_type == CALL_STACK_FOLDED) {
+		for (size_t i = 0; i < call_nodes.size(); i++) {
+			if (call_nodes[i].cycles) {
+				fprintf(file, "%s %llu\n", call_path((int)i).c_str(), (unsigned long long)call_nodes[i].cycles);
+			}
+		}
+	}
+	else {
+		// A function's total is the cycles of every call path it is on,
+		// counted once however often it recurses in that path.
+		map<string, pair<uint64_t, uint64_t>> functions;  // Total and self cycles by name.
+		uint64_t total = 0;
+		for (size_t i = 0; i < call_nodes.size(); i++) {
+			uint64_t cycles = call_nodes[i].cycles;
+			total += cycles;
+			if (i == 0) {
+				functions["(top level)"].second += cycles;
+				functions["(top level)"].first += cycles;
+				continue;
+			}
+			functions[symbol_name(call_nodes[i].key >> 16, call_nodes[i].key & 0xFFFF)].second += cycles;
+			set<string> on_path;
+			for (int node = (int)i; node > 0; node = call_nodes[node].parent) {
+				on_path.insert(symbol_name(call_nodes[node].key >> 16, call_nodes[node].key & 0xFFFF));
+			}
+			for (set<string>::const_iterator name = on_path.begin(); name != on_path.end(); ++name) {
+				functions[*name].first += cycles;
+			}
+		}
+
+		vector<pair<string, pair<uint64_t, uint64_t>>> sorted(functions.begin(), functions.end());
+		stable_sort(sorted.begin(), sorted.end(),
+			[](const pair<string, pair<uint64_t, uint64_t>>& a, const pair<string, pair<uint64_t, uint64_t>>& b) { return a.second.first > b.second.first; });
+
+		double per_frame = frames > 0 ? 1.0 / frames : 1.0;
+		fprintf(file, "Call stacks: %llu cycles over %d frames\n", (unsigned long long)total, frames);
+		fprintf(file, "  total/frame  self/frame  total %%   self %%  function\n");
+		for (size_t i = 0; i < sorted.size(); i++) {
+			uint64_t function_total = sorted[i].second.first;
+			uint64_t function_self = sorted[i].second.second;
+			fprintf(file, "  %11.1f  %10.1f  %7.2f  %7.2f  %s\n", function_total * per_frame, function_self * per_frame,
+				total ? 100.0 * function_total / total : 0.0, total ? 100.0 * function_self / total : 0.0, sorted[i].first.c_str());
+		}
+	}
+
+	if (to_stdout) {
+		fflush(stdout);
+	}
+	else {
+		fclose(file);
+	}
+
+	if (returns_without_call || changed_returns || discarded_frames) {
+		fprintf(stderr, "Call stacks: %llu returns without a call, %llu changed returns, %llu discarded frames\n",
+			(unsigned long long)returns_without_call, (unsigned long long)changed_returns, (unsigned long long)discarded_frames);
+	}
+}
+
+string call_path(int node) {
+	if (node == 0) {
+		return "(top level)";
+	}
+	string path = symbol_name(call_nodes[node].key >> 16, call_nodes[node].key & 0xFFFF);
+	for (node = call_nodes[node].parent; node > 0; node = call_nodes[node].parent) {
+		path = symbol_name(call_nodes[node].key >> 16, call_nodes[node].key & 0xFFFF) + ";" + path;
+	}
+	return path;
+}
@@ -0,0 +1,37 @@
+// Shadow call stack. With call_stack_enabled the core reports every CALL,
+// RST, interupt dispatch, RET and RETI here, and a host side copy of the
+// call stack is kept next to the emulated one. Emulated cycles are charged
+// to the call path that was current while they ran, building a tree of
+// call paths that is written out as folded stacks or a per function report.
+//
+// Frames are matched up by stack pointer, not return address, so roms that
+// play tricks with the stack still come out sensibly:
+// - A return whose address was changed on the stack (inline arguments after
+//   a CALL) still ends the call. It is counted as a changed return.
+// - A RET with more on the stack than the frame left ("push address, ret"
+//   used as a jump) ends no call. It is counted as a return without a call.
+// - Frames whose return address was dropped from the stack (SP moved past
+//   it) are discarded at the next call or return. They are counted too.
+#pragma once
+
+#include <stdint.h>
+
+enum call_stack_format {
+	CALL_STACK_FOLDED,  // "caller;callee cycles" lines for flamegraph.pl.
+	CALL_STACK_REPORT,  // Total and self cycles per function, per frame.
+};
+
+extern bool call_stack_enabled;  // Set by start_call_stack().
+
+// Starts tracking calls. filename is where write_call_stack() writes to, "-"
+// for stdout. Call before starting the core.
+void start_call_stack(const char* filename, call_stack_format format);
+
+// Run by the core. sp is the stack pointer before the return address is
+// pushed or popped, now the emulated cycle.
+void shadow_call(uint16_t return_address, uint16_t sp, uint16_t target, int target_bank, uint64_t now);
+void shadow_return(uint16_t return_address, uint16_t sp, uint64_t now);
+
+// Charges the cycles up to now and writes the call paths out. Call after the
+// core has stopped.
+void write_call_stack(uint64_t now, int frames);
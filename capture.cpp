@@ -0,0 +1,171 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "capture.h"
+#include "gameboy.h"
+#include "spsc_queue.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#define PIPE_MODE "wb"
+#else
+#define PIPE_MODE "w"
+#endif
+
+using namespace std;
+
+// One LCD frame is 154 lines of 456 cycles.
+const int CYCLES_PER_LCD_FRAME = 154 * 456;
+
+const size_t CAPTURE_FRAMES = 16;             // Frames the ring can hold (one slot is kept free).
+const size_t CAPTURE_WRITE_BUFFER = 1 << 20;  // stdio buffer for the output, so writes go out in large blocks.
+const size_t CAPTURE_FRAME_BYTES = SCREEN_WIDTH * SCREEN_HEIGHT * 3;
+
+bool capture_enabled = false;
+
+SpscQueue<frame, CAPTURE_FRAMES> capture_ring;  // Filled by publish_frame(), drained by the writer.
+frame capture_out;                              // Frame the writer is converting. Writer thread only.
+uint8_t capture_bytes[CAPTURE_FRAME_BYTES];     // Converted frame. Writer thread only.
+capture_format capture_type;
+FILE* capture_file = NULL;
+bool capture_pipe = false;
+std::atomic<bool> capture_running(false);
+thread capture_writer;
+
+uint64_t frames_captured = 0;  // Written by the writer thread.
+uint64_t frames_repeated = 0;  // Written by the writer thread.
+uint64_t frames_dropped = 0;   // Written by whichever thread publishes frames.
+uint64_t capture_start = 0;    // Emulated time of the first frame written.
+
+void capture_loop();                            // Writer thread body.
+void write_captured_frame(const frame& frame);  // Converts one frame and writes it out.
+void write_capture_bytes();                     // Writes out the last converted frame.
+
+void start_capture(const char* target, capture_format format) {
+	if (target[0] == '|') {
+		capture_file = popen(target + 1, PIPE_MODE);
+		capture_pipe = true;
+	}
+	else {
+		capture_file = fopen(target, "wb");
+	}
+	if (capture_file == NULL) {
+		cerr << "Could not open capture output " << target << endl;
+		exit(1);
+	}
+	setvbuf(capture_file, NULL, _IOFBF, CAPTURE_WRITE_BUFFER);
+
+	capture_type = format;
+	if (capture_type == CAPTURE_Y4M) {
+		fprintf(capture_file, "YUV4MPEG2 W%d H%d F%d:%d Ip A1:1 C444\n",
+			SCREEN_WIDTH, SCREEN_HEIGHT, CLOCKSPEED, CYCLES_PER_LCD_FRAME);
+	}
+
+	capture_enabled = true;
+	capture_running = true;
+	capture_writer = thread(capture_loop);
+}
+
+void capture_frame(const frame& frame) {
+	if (!capture_ring.push(frame)) {
+		frames_dropped++;
+	}
+}
+
+void stop_capture() {
+	if (!capture_enabled) {
+		return;
+	}
+
+	capture_running = false;
+	capture_writer.join();
+
+	if (capture_pipe) {
+		pclose(capture_file);
+	}
+	else {
+		fclose(capture_file);
+	}
+	capture_enabled = false;
+
+	cout << "Captured " << frames_captured << " frames, dropped " << frames_dropped << ", repeated "
+		<< frames_repeated << " to fill gaps" << endl;
+}
+
+void capture_loop() {
+	while (true) {
+		if (capture_ring.pop(capture_out)) {
+			write_captured_frame(capture_out);
+			continue;
+		}
+
+		// Anything queued before the stop is still written out.
+		if (!capture_running) {
+			while (capture_ring.pop(capture_out)) {
+				write_captured_frame(capture_out);
+			}
+			break;
+		}
+		this_thread::sleep_for(chrono::milliseconds(1));
+	}
+	fflush(capture_file);
+}
+
+void write_captured_frame(const frame& frame) {
+	// Keep the output on the emulated timeline, so it lines up with a WAV
+	// recording. Frames that were dropped, or never drawn because the LCD was
+	// off, are filled in with the last frame written.
+	if (frames_captured == 0) {
+		capture_start = frame.time;
+	}
+	else {
+		uint64_t slot = (frame.time - capture_start + CYCLES_PER_LCD_FRAME / 2) / CYCLES_PER_LCD_FRAME;
+		while (frames_captured + frames_repeated < slot) {
+			write_capture_bytes();
+			frames_repeated++;
+		}
+	}
+
+	const uint32_t* pixels = &frame.pixels[0][0];
+	const int count = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+	if (capture_type == CAPTURE_Y4M) {
+		// Planar Y, Cb, Cr at full resolution, studio range.
+		uint8_t* y = capture_bytes;
+		uint8_t* cb = y + count;
+		uint8_t* cr = cb + count;
+		for (int i = 0; i < count; i++) {
+			int r = (pixels[i] >> 16) & 0xFF;
+			int g = (pixels[i] >> 8) & 0xFF;
+			int b = pixels[i] & 0xFF;
+			y[i] = (uint8_t)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+			cb[i] = (uint8_t)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			cr[i] = (uint8_t)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+	else {
+		uint8_t* out = capture_bytes;
+		for (int i = 0; i < count; i++) {
+			*out++ = (uint8_t)(pixels[i] >> 16);
+			*out++ = (uint8_t)(pixels[i] >> 8);
+			*out++ = (uint8_t)pixels[i];
+		}
+	}
+
+	write_capture_bytes();
+	frames_captured++;
+}
+
+void write_capture_bytes() {
+	if (capture_type == CAPTURE_Y4M) {
+		fputs("FRAME\n", capture_file);
+	}
+	fwrite(capture_bytes, 1, CAPTURE_FRAME_BYTES, capture_file);
+}
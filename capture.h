@@ -0,0 +1,31 @@
+// Video capture. Every published frame is copied into a ring of preallocated
+// buffers and a writer thread streams them out, so capturing never makes the
+// emulation wait. Frames that find the ring full are dropped and counted,
+// and the gaps they leave are filled with the frame before so the output
+// keeps to one frame per 70224 emulated cycles.
+//
+// Raw output is packed RGB24, 160x144, one frame after another:
+//   ffmpeg -f rawvideo -pixel_format rgb24 -video_size 160x144 -framerate 59.73 -i capture.raw ...
+// Y4M output is 8 bit YCbCr 4:4:4 (BT.601) and is read by most tools as is.
+#pragma once
+
+#include "gameboy.h"
+
+enum capture_format {
+	CAPTURE_RAW,
+	CAPTURE_Y4M,
+};
+
+extern bool capture_enabled;  // Set by start_capture().
+
+// Opens target and starts the writer thread. target is a file name, or
+// "|command" to pipe the frames into a program (ffmpeg -i - ...). Call before
+// starting the core.
+void start_capture(const char* target, capture_format format);
+
+// Queues a copy of a finished frame. Called by publish_frame().
+void capture_frame(const frame& frame);
+
+// Writes out the queued frames, closes the output and reports how many frames
+// were written and dropped. Call after the core and renderer have stopped.
+void stop_capture();
@@ -0,0 +1,193 @@
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <string>
+
+#include "doctor.h"
+#include "gameboy.h"
+
+using namespace std;
+
+bool doctor_enabled = false;
+const char* doctor_log = NULL;   // The mapped log.
+const char* doctor_end = NULL;
+const char* doctor_next = NULL;  // Start of the next line to compare.
+uint64_t doctor_lines = 0;       // Lines that matched.
+bool doctor_diverged = false;
+int doctor_context = 8;
+string doctor_file;
+
+#ifdef _WIN32
+HANDLE doctor_mapping = NULL;
+#endif
+
+const char* map_doctor_log(const char* filename, size_t& size);  // Maps filename read only, NULL on failure.
+void unmap_doctor_log();
+void print_divergence(const char* line, const char* expected, size_t expected_length);
+bool same_line(const char* line, const char* expected, size_t expected_length);  // Ignores the case of hex digits.
+
+void start_doctor(const char* filename, int context) {
+	size_t size = 0;
+	doctor_log = map_doctor_log(filename, size);
+	if (doctor_log == NULL) {
+		fprintf(stderr, "Could not read %s\n", filename);
+		exit(1);
+	}
+	doctor_end = doctor_log + size;
+	doctor_next = doctor_log;
+	doctor_file = filename;
+	doctor_context = context;
+	doctor_enabled = true;
+}
+
+void compare_doctor_line(const char* line) {
+	if (doctor_next >= doctor_end) {
+		doctor_enabled = false;
+		stop_core();
+		return;
+	}
+
+	const char* end = (const char*)memchr(doctor_next, '\n', doctor_end - doctor_next);
+	const char* next = end ? end + 1 : doctor_end;
+	if (end == NULL) {
+		end = doctor_end;
+	}
+	if (end > doctor_next && end[-1] == '\r') {
+		end--;
+	}
+
+	size_t length = end - doctor_next;
+	if ((length != DOCTOR_LINE_LENGTH || memcmp(line, doctor_next, DOCTOR_LINE_LENGTH)) && !same_line(line, doctor_next, length)) {
+		print_divergence(line, doctor_next, length);
+		doctor_diverged = true;
+		doctor_enabled = false;
+		stop_core();
+		return;
+	}
+	doctor_lines++;
+	doctor_next = next;
+}
+
+bool stop_doctor() {
+	if (doctor_log == NULL) {
+		return true;
+	}
+	if (!doctor_diverged) {
+		if (doctor_next >= doctor_end) {
+			printf("Doctor: all %llu lines of %s matched\n", (unsigned long long)doctor_lines, doctor_file.c_str());
+		}
+		else {
+			printf("Doctor: %llu lines of %s matched, stopped before the end of it\n", (unsigned long long)doctor_lines, doctor_file.c_str());
+		}
+	}
+	unmap_doctor_log();
+	doctor_log = NULL;
+	doctor_enabled = false;
+	return !doctor_diverged;
+}
+
+void print_divergence(const char* line, const char* expected, size_t expected_length) {
+	// The lines before it matched, so the log shows what ran up to here.
+	const char* start = expected;
+	for (int i = 0; i < doctor_context && start > doctor_log; i++) {
+		start--;
+		while (start > doctor_log && start[-1] != '\n') {
+			start--;
+		}
+	}
+	printf("Doctor: line %llu of %s differs\n", (unsigned long long)doctor_lines + 1, doctor_file.c_str());
+	while (start < expected) {
+		const char* end = (const char*)memchr(start, '\n', expected - start);
+		int length = (int)(end - start);
+		printf("  %.*s\n", length > 0 && start[length - 1] == '\r' ? length - 1 : length, start);
+		start = end + 1;
+	}
+	printf("< %.*s\n", (int)expected_length, expected);
+	printf("> %.*s\n", (int)DOCTOR_LINE_LENGTH, line);
+
+	// Mark the fields that differ. Lines of the wrong length are marked from
+	// where they stop matching.
+	string marks(DOCTOR_LINE_LENGTH, ' ');
+	for (size_t i = 0; i < DOCTOR_LINE_LENGTH; i++) {
+		if (i >= expected_length || toupper((unsigned char)line[i]) != toupper((unsigned char)expected[i])) {
+			marks[i] = '^';
+		}
+	}
+	printf("  %s\n", marks.c_str());
+	fflush(stdout);
+}
+
+bool same_line(const char* line, const char* expected, size_t expected_length) {
+	if (expected_length != DOCTOR_LINE_LENGTH) {
+		return false;
+	}
+	for (size_t i = 0; i < DOCTOR_LINE_LENGTH; i++) {
+		if (toupper((unsigned char)line[i]) != toupper((unsigned char)expected[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+#ifdef _WIN32
+const char* map_doctor_log(const char* filename, size_t& size) {
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return NULL;
+	}
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		CloseHandle(file);
+		return NULL;
+	}
+	size = (size_t)file_size.QuadPart;
+	doctor_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (doctor_mapping == NULL) {
+		return NULL;
+	}
+	return (const char*)MapViewOfFile(doctor_mapping, FILE_MAP_READ, 0, 0, 0);
+}
+
+void unmap_doctor_log() {
+	UnmapViewOfFile(doctor_log);
+	CloseHandle(doctor_mapping);
+}
+#else
+const char* map_doctor_log(const char* filename, size_t& size) {
+	int file = open(filename, O_RDONLY);
+	if (file < 0) {
+		return NULL;
+	}
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0) {
+		close(file);
+		return NULL;
+	}
+	size = (size_t)status.st_size;
+	void* log = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (log == MAP_FAILED) {
+		return NULL;
+	}
+	madvise(log, size, MADV_SEQUENTIAL);
+	return (const char*)log;
+}
+
+void unmap_doctor_log() {
+	munmap((void*)doctor_log, doctor_end - doctor_log);
+}
+#endif
@@ -0,0 +1,32 @@
+// Differential trace against a gameboy-doctor log. The reference emulator's
+// log has one line per instruction with the state before it runs:
+//
+//   A:01 F:B0 B:00 C:13 D:00 E:D8 H:01 L:4D SP:FFFE PC:0100 PCMEM:00,C3,13,02
+//
+// starting at 0x100, right after the boot rom. With doctor_enabled the core
+// writes the same line for every instruction once the boot rom is done, and
+// it is compared with the next line of the log, which is mapped into memory
+// rather than read, so logs of any size stream through without being held.
+// The core stops at the first line that differs, or when the log ends.
+//
+// The logs are made with LY (0xFF44) always reading 0x90, so while this is
+// on the core does the same.
+#pragma once
+
+#include <stddef.h>
+
+const size_t DOCTOR_LINE_LENGTH = 73;  // Without the line break.
+
+extern bool doctor_enabled;  // Set by start_doctor(), cleared once the core is to stop.
+
+// Maps the log in filename. context is how many lines before a difference
+// are printed with it. Exits if the log cannot be read. Call before starting
+// the core.
+void start_doctor(const char* filename, int context);
+
+// Compares the core's line with the next one of the log. Run by the core.
+void compare_doctor_line(const char* line);
+
+// Prints how the comparison went and unmaps the log. False if a line
+// differed. Call after the core has stopped.
+bool stop_doctor();
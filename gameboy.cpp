@@ -0,0 +1,4342 @@
+﻿#include <malloc.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <windows.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "apu.h"
+#include "callstack.h"
+#include "cb.h"
+#include "cpu.h"
+#include "doctor.h"
+#include "gameboy.h"
+#include "hotspot.h"
+#include "ppu.h"
+#include "profile.h"
+#include "renderer.h"
+#include "serial.h"
+#include "timeline.h"
+#include "trace.h"
+
+using namespace std;
+
+int timer_count = 0;
+uint16_t curr_clock_speed = 1024;
+int divider_count = 0;
+
+// Operands (either one depending on size).
+uint8_t Operand8;
+uint16_t Operand16;
+
+// Cycle Counter
+long int cycle_count;          // Cycles run in the current frame.
+uint64_t emulated_cycles = 0;  // Cycles run before the current frame.
+
+// Stores amount of cycles in last instruction.
+int last_cycles;
+
+bool IME = 0;  // Interrupt Master Enable Flag.
+
+// Graphics Variables
+int scanline_count = 456;  // Cycles left in the current line.
+int ppu_deadline = 376;    // Value of scanline_count at which the next mode change happens.
+uint8_t ppu_mode = 2;      // 0 HBLANK, 1 VBLANK, 2 OAM search, 3 transfer.
+bool lcd_enabled = false;  // Mirrors bit 7 of 0xFF40.
+bool stat_line = false;    // Combined STAT interupt sources, interupt fires on its rising edge.
+
+// Registers that affect drawing, logged at the end of each visible line
+// and drawn by the renderer at VBLANK. VRAM writes while some logged lines
+// are still undrawn make the core draw them first.
+line_registers line_log[SCREEN_HEIGHT];
+int lines_logged = 0;       // Lines of this frame in line_log.
+int lines_drawn = 0;        // Lines of this frame already drawn by flush_lines().
+uint32_t vram_version = 0;  // Bumped on every write that changes VRAM.
+
+// Palettes. Every possible value of a palette register is decoded ahead of
+// time into host pixels for each colour scheme, so a write to BGP, OBP0 or
+// OBP1 only moves a pointer and drawing is a single table lookup.
+const uint32_t color_schemes[COLOR_SCHEMES][4] = {
+	{ 0xFFFFFFFF, 0xFFB4B4B4, 0xFF6E6E6E, 0xFF000000 },  // Grey
+	{ 0xFF9BBC0F, 0xFF8BAC0F, 0xFF306230, 0xFF0F380F },  // DMG green
+	{ 0xFFC4CFA1, 0xFF8B956D, 0xFF4D533C, 0xFF1F1F1F },  // Pocket
+};
+uint32_t palette_tables[COLOR_SCHEMES][256][4];
+const uint32_t (*palette_table)[4] = palette_tables[0];  // Tables for the active scheme.
+const uint32_t* bg_palette = palette_table[0];            // Decoded 0xFF47.
+const uint32_t* obj_palette[2] = { palette_table[0], palette_table[0] };  // Decoded 0xFF48, 0xFF49.
+std::atomic<int> color_scheme(0);
+int active_color_scheme = 0;
+
+// Front end communication.
+SpscQueue<input_event, 64> input_queue;
+std::atomic<bool> emulation_running(true);
+bool throttle_enabled = true;
+int frame_limit = 0;
+bool breakpoint_stop_enabled = false;
+bool breakpoint_hit = false;
+bool core_stopped = false;
+
+// Benchmark counters.
+uint64_t instruction_count = 0;
+bool subsystem_timing_enabled = false;
+uint64_t subsystem_time[SUBSYSTEMS];
+uint64_t tick_overhead = 0;  // Ticks between two back to back counter reads, taken off every step.
+
+// Joypad Variable
+uint8_t joypad_state = 0xFF;
+
+// Input movie. Key presses replayed at the start of the frame they were
+// recorded for, so a headless run with a movie always plays out the same.
+struct movie_event {
+	int frame;
+	int key;
+	bool pressed;
+};
+std::vector<movie_event> movie;
+size_t movie_position = 0;  // Next event to replay.
+int frame_count = 0;        // Frames emulated so far.
+
+// Memory Variables
+/*
+$FFFF           Interrupt Enable Flag
+$FF80-$FFFE     Zero Page - 127 bytes
+$FF00-$FF7F     Hardware I/O Registers
+$FEA0-$FEFF     Unusable Memory
+$FE00-$FE9F     OAM - Object Attribute Memory
+$E000-$FDFF     Echo RAM - Reserved, Do Not Use
+$D000-$DFFF     Internal RAM - Bank 1-7 (switchable - CGB only)
+$C000-$CFFF     Internal RAM - Bank 0 (fixed)
+$A000-$BFFF     Cartridge RAM (If Available)
+$9C00-$9FFF     BG Map Data 2
+$9800-$9BFF     BG Map Data 1
+$8000-$97FF     TILE RAM (Graphics)
+$4000-$7FFF     Cartridge ROM - Switchable Banks 1-xx
+$0150-$3FFF     Cartridge ROM - Bank 0 (fixed)
+$0100-$014F     Cartridge Header Area
+$0000-$00FF     Restart and Interrupt Vectors
+*/
+
+uint8_t memory[65536] = { 0 };
+uint8_t* rom;
+uint8_t* boot_rom;
+bool enable_boot = true;
+uint8_t bank_offset = 0;
+
+bool mbc1 = false;
+bool mbc2 = false;
+
+// Registers
+struct registers {
+	struct {
+		union {
+			struct {
+				uint8_t f;  // Flag Register. [z,n,h,c,0,0,0,0]
+				uint8_t a;
+			};
+			uint16_t af;
+		};
+	};
+	struct {
+		union {
+			struct {
+				uint8_t c;
+				uint8_t b;
+			};
+			uint16_t bc;
+		};
+	};
+	struct {
+		union {
+			struct {
+				uint8_t e;
+				uint8_t d;
+			};
+			uint16_t de;
+		};
+	};
+	struct {
+		union {
+			struct {
+				uint8_t l;
+				uint8_t h;
+			};
+			uint16_t hl;
+		};
+	};
+	uint16_t sp;  // Stack pointer.
+	uint16_t pc;  // Program counter.
+} registers;
+
+// Instruction Lookup Struct
+struct instruction {
+	int length;
+	void (*fcnPtr)();
+};
+
+// User I/O
+uint8_t key_state();        // Sets up FF00 depending on key presses.
+void key_press(int key);    // Does a key press
+void key_release(int key);  // Does a key release
+void process_input();       // Applies key presses queued by the front end.
+
+// Memory Operations
+uint8_t read_byte(uint16_t location);              // Read memory at location.
+void write_byte(uint8_t data, uint16_t location);  // Write memory at location.
+void write_io(uint8_t data, uint16_t location);    // Write to a hardware register.
+void write_vram(uint8_t data, uint16_t location);  // Write to video ram, drawing pending lines first.
+int rom_bank(uint16_t location);                   // Bank of location the way RGBDS numbers them, -1 in the boot rom.
+void dma_transfer(uint8_t data);                   // Does a direct memory transfer.
+
+// CPU Operations
+void cpu_cycle();  // Reads current opcode then executes instruction. Also prints output.
+void trace_instruction(uint8_t opcode);  // Adds the state before opcode runs to the trace.
+void doctor_instruction();               // Compares the state before the next instruction with the gameboy-doctor log.
+void interupts();  // Checks if there is any interputs to do and then does them.
+void do_interupt(uint8_t interupt);    // Carries out the specified interupt and resets ime.
+void set_interupt(uint8_t interupt);   // Allows for interupts to be set.
+void update_timers();
+void measure_tick_overhead();  // Sets tick_overhead for subsystem timing.
+void record_subsystem_shares();  // Adds the share of the last frame each subsystem took to the timeline.
+
+// Graphics functions.
+void log_line();     // Records the registers for the current line in line_log.
+void flush_lines();  // Draws logged lines that have not been drawn yet.
+void set_color_scheme(int scheme);  // Swaps palette tables to another colour scheme.
+void increment_scan_line();  // Counts down the current line and runs ppu_event() at each deadline.
+void ppu_event();            // Moves the PPU on to its next mode.
+void set_lcd_enabled(bool enabled);  // Handles the LCD being switched on or off.
+
+// Arithmetic Instructions (on register a).
+void add_byte(uint8_t value2);                // Adds value2 to register a and sets relevent flags.
+uint16_t add_2_byte(uint16_t a,	uint16_t b);  // Adds a to b and sets relevent flags.
+void sub_byte(uint8_t value);                 // Subtracts value from register a and sets relevant flags.
+void adc(uint8_t a);
+void cp(uint8_t value);  // Compare value with register a setting flags. (Basically subtraction without storing value)
+
+uint8_t inc(uint8_t value);  // Increment value and set flags.
+uint8_t dec(uint8_t value);  // Decrement value and set flags.
+
+// Rotations.
+uint8_t RotByteLeft(uint8_t number);   // Rotate left and set carry flag.
+uint8_t RotByteRight(uint8_t number);  // Rotate right and set carry flag.
+
+uint8_t Rotate_Left_Carry(uint8_t number);   // Rotate left into carry.
+uint8_t Rotate_Right_Carry(uint8_t number);  // Rotate right into carry.
+
+// Shifts.
+uint8_t Shift_Left(uint8_t number);   // Shift left into carry.
+uint8_t Shift_Right(uint8_t number);  // Shift right into carry.
+
+uint8_t Shift_Right_A(uint8_t number);  // Arithmetic Shift.
+
+// Swap.
+uint8_t Swap(uint8_t number);  // Swaps highest 4 bits with lowest 4 bits.
+
+// Logic
+void And(uint8_t a);  // register a AND value.
+void Or(uint8_t a);   // register a OR value.
+void Xor(uint8_t a);  // register a XOR value.
+
+// Stack Instructions.
+void Push(uint16_t a);  // Places value on top of stack and decrements stack pointer.
+uint16_t Pop();         // Stack value off stack, stores it and increments stack pointer.
+void Call(uint16_t a);  // Pushes pc and jumps to a, telling the shadow call stack.
+void Return();          // Pops pc, telling the shadow call stack.
+
+// Bit tests.
+uint8_t Bit_Test(uint8_t bit, uint8_t number);
+uint8_t test_bit(uint8_t bit, uint8_t number);  // Doesn't set flags.
+
+// Bit sets.
+uint8_t Res(uint8_t bit, uint8_t number);  // Resets specified bit.
+uint8_t Set(uint8_t bit, uint8_t number);  // Sets specified bit.
+
+// Flag functions.
+void Set_Z_Flag();  // Set zero flag.
+void Set_N_Flag();  // Set negative flag.
+void Set_H_Flag();  // Set half-carry flag.
+void Set_C_Flag();  // Set full-carry flag.
+
+void Clear_Z_Flag();  // Clear zero flag.
+void CLear_N_Flag();  // Clear negative flag.
+void Clear_H_Flag();  // Clear half-carry flag.
+void Clear_C_Flag();  // Clear carry flag.
+
+// PPU implementations. The default runs the mode machine on fixed deadlines
+// and has whole lines drawn by the renderer. Building with PPU_FIFO (see
+// CMakeLists.txt) swaps in the dot by dot pixel FIFO from ppu_fifo.cpp for
+// games that change registers mid-line. The choice is made at compile time
+// so the default loop carries no extra checks.
+struct line_ppu {
+	static void start() { start_renderer(); }
+	static void stop() { stop_renderer(); }
+	static void step() { increment_scan_line(); }
+	static void start_frame() {}
+	static void before_vram_write() {
+		// Lines logged so far have to be drawn with VRAM as it was.
+		if (lines_drawn < lines_logged) {
+			flush_lines();
+		}
+	}
+};
+
+struct fifo_ppu {
+	static void start() {}
+	static void stop() {}
+	static void step() { fifo_step(); }
+	static void start_frame() { fifo_start_frame(); }
+	static void before_vram_write() {}
+};
+
+#ifdef PPU_FIFO
+typedef fifo_ppu ppu;
+#else
+typedef line_ppu ppu;
+#endif
+
+// Array of structures that uses instruction opcode as index and stores
+// length and function pointer. The names are in opcode_names.cpp.
+const struct instruction instructions[] = {
+	{1, NOP},          //    0x0
+	{3, LD_BC_d16},    //    0x1
+	{1, LD_BCp_A},     //    0x2
+	{1, INC_BC},       //    0x3
+	{1, INC_B},        //    0x4
+	{1, DEC_B},        //    0x5
+	{2, LD_B_d8},      //    0x6
+	{1, RLCA},         //    0x7
+	{3, LD_a16p_SP},   //    0x8
+	{1, ADD_HL_BC},    //    0x9
+	{1, LD_A_BCp},     //    0xa
+	{1, DEC_BC},       //    0xb
+	{1, INC_C},        //    0xc
+	{1, DEC_C},        //    0xd
+	{2, LD_C_d8},      //    0xe
+	{1, RRCA},         //    0xf
+	{1, STOP_0},       //    0x10
+	{3, LD_DE_d16},    //    0x11
+	{1, LD_DEp_A},     //    0x12
+	{1, INC_DE},       //    0x13
+	{1, INC_D},        //    0x14
+	{1, DEC_D},        //    0x15
+	{2, LD_D_d8},      //    0x16
+	{1, RLA},          //    0x17
+	{2, JR_r8},        //    0x18
+	{1, ADD_HL_DE},    //    0x19
+	{1, LD_A_DEp},     //    0x1a
+	{1, DEC_DE},       //    0x1b
+	{1, INC_E},        //    0x1c
+	{1, DEC_E},        //    0x1d
+	{2, LD_E_d8},      //    0x1e
+	{1, RRA},          //    0x1f
+	{2, JR_NZ_r8},     //    0x20
+	{3, LD_HL_d16},    //    0x21
+	{1, LD_HLIp_A},    //    0x22
+	{1, INC_HL},       //    0x23
+	{1, INC_H},        //    0x24
+	{1, DEC_H},        //    0x25
+	{2, LD_H_d8},      //    0x26
+	{1, DAA},          //    0x27
+	{2, JR_Z_r8},      //    0x28
+	{1, ADD_HL_HL},    //    0x29
+	{1, LD_A_HLIp},    //    0x2a
+	{1, DEC_HL},       //    0x2b
+	{1, INC_L},        //    0x2c
+	{1, DEC_L},        //    0x2d
+	{2, LD_L_d8},      //    0x2e
+	{1, CPL},          //    0x2f
+	{2, JR_NC_r8},     //    0x30
+	{3, LD_SP_d16},    //    0x31
+	{1, LD_HLdp_A},    //    0x32
+	{1, INC_SP},       //    0x33
+	{1, INC_HLp},      //    0x34
+	{1, DEC_HLp},      //    0x35
+	{2, LD_HLp_d8},    //    0x36
+	{1, SCF},          //    0x37
+	{2, JR_C_r8},      //    0x38
+	{1, ADD_HL_SP},    //    0x39
+	{1, LD_A_HLdp},    //    0x3a
+	{1, DEC_SP},       //    0x3b
+	{1, INC_A},        //    0x3c
+	{1, DEC_A},        //    0x3d
+	{2, LD_A_d8},      //    0x3e
+	{1, CCF},          //    0x3f
+	{1, LD_B_B},       //    0x40
+	{1, LD_B_C},       //    0x41
+	{1, LD_B_D},       //    0x42
+	{1, LD_B_E},       //    0x43
+	{1, LD_B_H},       //    0x44
+	{1, LD_B_L},       //    0x45
+	{1, LD_B_HLp},     //    0x46
+	{1, LD_B_A},       //    0x47
+	{1, LD_C_B},       //    0x48
+	{1, LD_C_C},       //    0x49
+	{1, LD_C_D},       //    0x4a
+	{1, LD_C_E},       //    0x4b
+	{1, LD_C_H},       //    0x4c
+	{1, LD_C_L},       //    0x4d
+	{1, LD_C_HLp},     //    0x4e
+	{1, LD_C_A},       //    0x4f
+	{1, LD_D_B},       //    0x50
+	{1, LD_D_C},       //    0x51
+	{1, LD_D_D},       //    0x52
+	{1, LD_D_E},       //    0x53
+	{1, LD_D_H},       //    0x54
+	{1, LD_D_L},       //    0x55
+	{1, LD_D_HLp},     //    0x56
+	{1, LD_D_A},       //    0x57
+	{1, LD_E_B},       //    0x58
+	{1, LD_E_C},       //    0x59
+	{1, LD_E_D},       //    0x5a
+	{1, LD_E_E},       //    0x5b
+	{1, LD_E_H},       //    0x5c
+	{1, LD_E_L},       //    0x5d
+	{1, LD_E_HLp},     //    0x5e
+	{1, LD_E_A},       //    0x5f
+	{1, LD_H_B},       //    0x60
+	{1, LD_H_C},       //    0x61
+	{1, LD_H_D},       //    0x62
+	{1, LD_H_E},       //    0x63
+	{1, LD_H_H},       //    0x64
+	{1, LD_H_L},       //    0x65
+	{1, LD_H_HLp},     //    0x66
+	{1, LD_H_A},       //    0x67
+	{1, LD_L_B},       //    0x68
+	{1, LD_L_C},       //    0x69
+	{1, LD_L_D},       //    0x6a
+	{1, LD_L_E},       //    0x6b
+	{1, LD_L_H},       //    0x6c
+	{1, LD_L_L},       //    0x6d
+	{1, LD_L_HLp},     //    0x6e
+	{1, LD_L_A},       //    0x6f
+	{1, LD_HLp_B},     //    0x70
+	{1, LD_HLp_C},     //    0x71
+	{1, LD_HLp_D},     //    0x72
+	{1, LD_HLp_E},     //    0x73
+	{1, LD_HLp_H},     //    0x74
+	{1, LD_HLp_L},     //    0x75
+	{1, HALT},         //    0x76
+	{1, LD_HLp_A},     //    0x77
+	{1, LD_A_B},       //    0x78
+	{1, LD_A_C},       //    0x79
+	{1, LD_A_D},       //    0x7a
+	{1, LD_A_E},       //    0x7b
+	{1, LD_A_H},       //    0x7c
+	{1, LD_A_L},       //    0x7d
+	{1, LD_A_HLp},     //    0x7e
+	{1, LD_A_A},       //    0x7f
+	{1, ADD_A_B},      //    0x80
+	{1, ADD_A_C},      //    0x81
+	{1, ADD_A_D},      //    0x82
+	{1, ADD_A_E},      //    0x83
+	{1, ADD_A_H},      //    0x84
+	{1, ADD_A_L},      //    0x85
+	{1, ADD_A_HLp},    //    0x86
+	{1, ADD_A_A},      //    0x87
+	{1, ADC_A_B},      //    0x88
+	{1, ADC_A_C},      //    0x89
+	{1, ADC_A_D},      //    0x8a
+	{1, ADC_A_E},      //    0x8b
+	{1, ADC_A_H},      //    0x8c
+	{1, ADC_A_L},      //    0x8d
+	{1, ADC_A_HLp},    //    0x8e
+	{1, ADC_A_A},      //    0x8f
+	{1, SUB_B},        //    0x90
+	{1, SUB_C},        //    0x91
+	{1, SUB_D},        //    0x92
+	{1, SUB_E},        //    0x93
+	{1, SUB_H},        //    0x94
+	{1, SUB_L},        //    0x95
+	{1, SUB_HLp},      //    0x96
+	{1, SUB_A},        //    0x97
+	{1, SBC_A_B},      //    0x98
+	{1, SBC_A_C},      //    0x99
+	{1, SBC_A_D},      //    0x9a
+	{1, SBC_A_E},      //    0x9b
+	{1, SBC_A_H},      //    0x9c
+	{1, SBC_A_L},      //    0x9d
+	{1, SBC_A_HLp},    //    0x9e
+	{1, SBC_A_A},      //    0x9f
+	{1, AND_B},        //    0xa0
+	{1, AND_C},        //    0xa1
+	{1, AND_D},        //    0xa2
+	{1, AND_E},        //    0xa3
+	{1, AND_H},        //    0xa4
+	{1, AND_L},        //    0xa5
+	{1, AND_HLp},      //    0xa6
+	{1, AND_A},        //    0xa7
+	{1, XOR_B},        //    0xa8
+	{1, XOR_C},        //    0xa9
+	{1, XOR_D},        //    0xaa
+	{1, XOR_E},        //    0xab
+	{1, XOR_H},        //    0xac
+	{1, XOR_L},        //    0xad
+	{1, XOR_HLp},      //    0xae
+	{1, XOR_A},        //    0xaf
+	{1, OR_B},         //    0xb0
+	{1, OR_C},         //    0xb1
+	{1, OR_D},         //    0xb2
+	{1, OR_E},         //    0xb3
+	{1, OR_H},         //    0xb4
+	{1, OR_L},         //    0xb5
+	{1, OR_HLp},       //    0xb6
+	{1, OR_A},         //    0xb7
+	{1, CP_B},         //    0xb8
+	{1, CP_C},         //    0xb9
+	{1, CP_D},         //    0xba
+	{1, CP_E},         //    0xbb
+	{1, CP_H},         //    0xbc
+	{1, CP_L},         //    0xbd
+	{1, CP_HLp},       //    0xbe
+	{1, CP_A},         //    0xbf
+	{1, RET_NZ},       //    0xc0
+	{1, POP_BC},       //    0xc1
+	{3, JP_NZ_a16},    //    0xc2
+	{3, JP_a16},       //    0xc3
+	{3, CALL_NZ_a16},  //    0xc4
+	{1, PUSH_BC},      //    0xc5
+	{2, ADD_A_d8},     //    0xc6
+	{1, RST_00H},      //    0xc7
+	{1, RET_Z},        //    0xc8
+	{1, RET},          //    0xc9
+	{3, JP_Z_a16},     //    0xca
+	{2, PREFIX_CB},    //    0xcb
+	{3, CALL_Z_a16},   //    0xcc
+	{3, CALL_a16},     //    0xcd
+	{2, ADC_A_d8},     //    0xce
+	{1, RST_08H},      //    0xcf
+	{1, RET_NC},       //    0xd0
+	{1, POP_DE},       //    0xd1
+	{3, JP_NC_a16},    //    0xd2
+	{0, NULL},         //    0xd3
+	{3, CALL_NC_a16},  //    0xd4
+	{1, PUSH_DE},      //    0xd5
+	{2, SUB_d8},       //    0xd6
+	{1, RST_10H},      //    0xd7
+	{1, RET_C},        //    0xd8
+	{1, RETI},         //    0xd9
+	{3, JP_C_a16},     //    0xda
+	{0, NULL},         //    0xdb
+	{3, CALL_C_a16},   //    0xdc
+	{0, NULL},         //    0xdd
+	{2, SBC_A_d8},     //    0xde
+	{1, RST_18H},      //    0xdf
+	{2, LDH_a8p_A},    //    0xe0
+	{1, POP_HL},       //    0xe1
+	{1, LD_Cp_A},      //    0xe2
+	{0, NULL},         //    0xe3
+	{0, NULL},         //    0xe4
+	{1, PUSH_HL},      //    0xe5
+	{2, AND_d8},       //    0xe6
+	{1, RST_20H},      //    0xe7
+	{2, ADD_SP_r8},    //    0xe8
+	{1, JP_HLp},       //    0xe9
+	{3, LD_a16p_A},    //    0xea
+	{0, NULL},         //    0xeb
+	{0, NULL},         //    0xec
+	{0, NULL},         //    0xed
+	{2, XOR_d8},       //    0xee
+	{1, RST_28H},      //    0xef
+	{2, LDH_A_a8p},    //    0xf0
+	{1, POP_AF},       //    0xf1
+	{1, LD_A_Cp},      //    0xf2
+	{1, DI},           //    0xf3
+	{0, NULL},         //    0xf4
+	{1, PUSH_AF},      //    0xf5
+	{2, OR_d8},        //    0xf6
+	{1, RST_30H},      //    0xf7
+	{2, LD_HL_SPr8},   //    0xf8
+	{1, LD_SP_HL},     //    0xf9
+	{3, LD_A_a16p},    //    0xfa
+	{1, EI},           //    0xfb
+	{0, NULL},         //    0xfc
+	{0, NULL},         //    0xfd
+	{2, CP_d8},        //    0xfe
+	{1, RST_38H},      //    0xff
+};
+
+// Array of structures for cb instruction.
+const struct instruction CB_instructions[] = {
+	{2, RLC_B},      //    0x0
+	{2, RLC_C},      //    0x1
+	{2, RLC_D},      //    0x2
+	{2, RLC_E},      //    0x3
+	{2, RLC_H},      //    0x4
+	{2, RLC_L},      //    0x5
+	{2, RLC_HLp},    //    0x6
+	{2, RLC_A},      //    0x7
+	{2, RRC_B},      //    0x8
+	{2, RRC_C},      //    0x9
+	{2, RRC_D},      //    0xa
+	{2, RRC_E},      //    0xb
+	{2, RRC_H},      //    0xc
+	{2, RRC_L},      //    0xd
+	{2, RRC_HLp},    //    0xe
+	{2, RRC_A},      //    0xf
+	{2, RL_B},       //    0x10
+	{2, RL_C},       //    0x11
+	{2, RL_D},       //    0x12
+	{2, RL_E},       //    0x13
+	{2, RL_H},       //    0x14
+	{2, RL_L},       //    0x15
+	{2, RL_HLp},     //    0x16
+	{2, RL_A},       //    0x17
+	{2, RR_B},       //    0x18
+	{2, RR_C},       //    0x19
+	{2, RR_D},       //    0x1a
+	{2, RR_E},       //    0x1b
+	{2, RR_H},       //    0x1c
+	{2, RR_L},       //    0x1d
+	{2, RR_HLp},     //    0x1e
+	{2, RR_A},       //    0x1f
+	{2, SLA_B},      //    0x20
+	{2, SLA_C},      //    0x21
+	{2, SLA_D},      //    0x22
+	{2, SLA_E},      //    0x23
+	{2, SLA_H},      //    0x24
+	{2, SLA_L},      //    0x25
+	{2, SLA_HLp},    //    0x26
+	{2, SLA_A},      //    0x27
+	{2, SRA_B},      //    0x28
+	{2, SRA_C},      //    0x29
+	{2, SRA_D},      //    0x2a
+	{2, SRA_E},      //    0x2b
+	{2, SRA_H},      //    0x2c
+	{2, SRA_L},      //    0x2d
+	{2, SRA_HLp},    //    0x2e
+	{2, SRA_A},      //    0x2f
+	{2, SWAP_B},     //    0x30
+	{2, SWAP_C},     //    0x31
+	{2, SWAP_D},     //    0x32
+	{2, SWAP_E},     //    0x33
+	{2, SWAP_H},     //    0x34
+	{2, SWAP_L},     //    0x35
+	{2, SWAP_HLp},   //    0x36
+	{2, SWAP_A},     //    0x37
+	{2, SRL_B},      //    0x38
+	{2, SRL_C},      //    0x39
+	{2, SRL_D},      //    0x3a
+	{2, SRL_E},      //    0x3b
+	{2, SRL_H},      //    0x3c
+	{2, SRL_L},      //    0x3d
+	{2, SRL_HLp},    //    0x3e
+	{2, SRL_A},      //    0x3f
+	{2, BIT_0_B},    //    0x40
+	{2, BIT_0_C},    //    0x41
+	{2, BIT_0_D},    //    0x42
+	{2, BIT_0_E},    //    0x43
+	{2, BIT_0_H},    //    0x44
+	{2, BIT_0_L},    //    0x45
+	{2, BIT_0_HLp},  //    0x46
+	{2, BIT_0_A},    //    0x47
+	{2, BIT_1_B},    //    0x48
+	{2, BIT_1_C},    //    0x49
+	{2, BIT_1_D},    //    0x4a
+	{2, BIT_1_E},    //    0x4b
+	{2, BIT_1_H},    //    0x4c
+	{2, BIT_1_L},    //    0x4d
+	{2, BIT_1_HLp},  //    0x4e
+	{2, BIT_1_A},    //    0x4f
+	{2, BIT_2_B},    //    0x50
+	{2, BIT_2_C},    //    0x51
+	{2, BIT_2_D},    //    0x52
+	{2, BIT_2_E},    //    0x53
+	{2, BIT_2_H},    //    0x54
+	{2, BIT_2_L},    //    0x55
+	{2, BIT_2_HLp},  //    0x56
+	{2, BIT_2_A},    //    0x57
+	{2, BIT_3_B},    //    0x58
+	{2, BIT_3_C},    //    0x59
+	{2, BIT_3_D},    //    0x5a
+	{2, BIT_3_E},    //    0x5b
+	{2, BIT_3_H},    //    0x5c
+	{2, BIT_3_L},    //    0x5d
+	{2, BIT_3_HLp},  //    0x5e
+	{2, BIT_3_A},    //    0x5f
+	{2, BIT_4_B},    //    0x60
+	{2, BIT_4_C},    //    0x61
+	{2, BIT_4_D},    //    0x62
+	{2, BIT_4_E},    //    0x63
+	{2, BIT_4_H},    //    0x64
+	{2, BIT_4_L},    //    0x65
+	{2, BIT_4_HLp},  //    0x66
+	{2, BIT_4_A},    //    0x67
+	{2, BIT_5_B},    //    0x68
+	{2, BIT_5_C},    //    0x69
+	{2, BIT_5_D},    //    0x6a
+	{2, BIT_5_E},    //    0x6b
+	{2, BIT_5_H},    //    0x6c
+	{2, BIT_5_L},    //    0x6d
+	{2, BIT_5_HLp},  //    0x6e
+	{2, BIT_5_A},    //    0x6f
+	{2, BIT_6_B},    //    0x70
+	{2, BIT_6_C},    //    0x71
+	{2, BIT_6_D},    //    0x72
+	{2, BIT_6_E},    //    0x73
+	{2, BIT_6_H},    //    0x74
+	{2, BIT_6_L},    //    0x75
+	{2, BIT_6_HLp},  //    0x76
+	{2, BIT_6_A},    //    0x77
+	{2, BIT_7_B},    //    0x78
+	{2, BIT_7_C},    //    0x79
+	{2, BIT_7_D},    //    0x7a
+	{2, BIT_7_E},    //    0x7b
+	{2, BIT_7_H},    //    0x7c
+	{2, BIT_7_L},    //    0x7d
+	{2, BIT_7_HLp},  //    0x7e
+	{2, BIT_7_A},    //    0x7f
+	{2, RES_0_B},    //    0x80
+	{2, RES_0_C},    //    0x81
+	{2, RES_0_D},    //    0x82
+	{2, RES_0_E},    //    0x83
+	{2, RES_0_H},    //    0x84
+	{2, RES_0_L},    //    0x85
+	{2, RES_0_HLp},  //    0x86
+	{2, RES_0_A},    //    0x87
+	{2, RES_1_B},    //    0x88
+	{2, RES_1_C},    //    0x89
+	{2, RES_1_D},    //    0x8a
+	{2, RES_1_E},    //    0x8b
+	{2, RES_1_H},    //    0x8c
+	{2, RES_1_L},    //    0x8d
+	{2, RES_1_HLp},  //    0x8e
+	{2, RES_1_A},    //    0x8f
+	{2, RES_2_B},    //    0x90
+	{2, RES_2_C},    //    0x91
+	{2, RES_2_D},    //    0x92
+	{2, RES_2_E},    //    0x93
+	{2, RES_2_H},    //    0x94
+	{2, RES_2_L},    //    0x95
+	{2, RES_2_HLp},  //    0x96
+	{2, RES_2_A},    //    0x97
+	{2, RES_3_B},    //    0x98
+	{2, RES_3_C},    //    0x99
+	{2, RES_3_D},    //    0x9a
+	{2, RES_3_E},    //    0x9b
+	{2, RES_3_H},    //    0x9c
+	{2, RES_3_L},    //    0x9d
+	{2, RES_3_HLp},  //    0x9e
+	{2, RES_3_A},    //    0x9f
+	{2, RES_4_B},    //    0xa0
+	{2, RES_4_C},    //    0xa1
+	{2, RES_4_D},    //    0xa2
+	{2, RES_4_E},    //    0xa3
+	{2, RES_4_H},    //    0xa4
+	{2, RES_4_L},    //    0xa5
+	{2, RES_4_HLp},  //    0xa6
+	{2, RES_4_A},    //    0xa7
+	{2, RES_5_B},    //    0xa8
+	{2, RES_5_C},    //    0xa9
+	{2, RES_5_D},    //    0xaa
+	{2, RES_5_E},    //    0xab
+	{2, RES_5_H},    //    0xac
+	{2, RES_5_L},    //    0xad
+	{2, RES_5_HLp},  //    0xae
+	{2, RES_5_A},    //    0xaf
+	{2, RES_6_B},    //    0xb0
+	{2, RES_6_C},    //    0xb1
+	{2, RES_6_D},    //    0xb2
+	{2, RES_6_E},    //    0xb3
+	{2, RES_6_H},    //    0xb4
+	{2, RES_6_L},    //    0xb5
+	{2, RES_6_HLp},  //    0xb6
+	{2, RES_6_A},    //    0xb7
+	{2, RES_7_B},    //    0xb8
+	{2, RES_7_C},    //    0xb9
+	{2, RES_7_D},    //    0xba
+	{2, RES_7_E},    //    0xbb
+	{2, RES_7_H},    //    0xbc
+	{2, RES_7_L},    //    0xbd
+	{2, RES_7_HLp},  //    0xbe
+	{2, RES_7_A},    //    0xbf
+	{2, SET_0_B},    //    0xc0
+	{2, SET_0_C},    //    0xc1
+	{2, SET_0_D},    //    0xc2
+	{2, SET_0_E},    //    0xc3
+	{2, SET_0_H},    //    0xc4
+	{2, SET_0_L},    //    0xc5
+	{2, SET_0_HLp},  //    0xc6
+	{2, SET_0_A},    //    0xc7
+	{2, SET_1_B},    //    0xc8
+	{2, SET_1_C},    //    0xc9
+	{2, SET_1_D},    //    0xca
+	{2, SET_1_E},    //    0xcb
+	{2, SET_1_H},    //    0xcc
+	{2, SET_1_L},    //    0xcd
+	{2, SET_1_HLp},  //    0xce
+	{2, SET_1_A},    //    0xcf
+	{2, SET_2_B},    //    0xd0
+	{2, SET_2_C},    //    0xd1
+	{2, SET_2_D},    //    0xd2
+	{2, SET_2_E},    //    0xd3
+	{2, SET_2_H},    //    0xd4
+	{2, SET_2_L},    //    0xd5
+	{2, SET_2_HLp},  //    0xd6
+	{2, SET_2_A},    //    0xd7
+	{2, SET_3_B},    //    0xd8
+	{2, SET_3_C},    //    0xd9
+	{2, SET_3_D},    //    0xda
+	{2, SET_3_E},    //    0xdb
+	{2, SET_3_H},    //    0xdc
+	{2, SET_3_L},    //    0xdd
+	{2, SET_3_HLp},  //    0xde
+	{2, SET_3_A},    //    0xdf
+	{2, SET_4_B},    //    0xe0
+	{2, SET_4_C},    //    0xe1
+	{2, SET_4_D},    //    0xe2
+	{2, SET_4_E},    //    0xe3
+	{2, SET_4_H},    //    0xe4
+	{2, SET_4_L},    //    0xe5
+	{2, SET_4_HLp},  //    0xe6
+	{2, SET_4_A},    //    0xe7
+	{2, SET_5_B},    //    0xe8
+	{2, SET_5_C},    //    0xe9
+	{2, SET_5_D},    //    0xea
+	{2, SET_5_E},    //    0xeb
+	{2, SET_5_H},    //    0xec
+	{2, SET_5_L},    //    0xed
+	{2, SET_5_HLp},  //    0xee
+	{2, SET_5_A},    //    0xef
+	{2, SET_6_B},    //    0xf0
+	{2, SET_6_C},    //    0xf1
+	{2, SET_6_D},    //    0xf2
+	{2, SET_6_E},    //    0xf3
+	{2, SET_6_H},    //    0xf4
+	{2, SET_6_L},    //    0xf5
+	{2, SET_6_HLp},  //    0xf6
+	{2, SET_6_A},    //    0xf7
+	{2, SET_7_B},    //    0xf8
+	{2, SET_7_C},    //    0xf9
+	{2, SET_7_D},    //    0xfa
+	{2, SET_7_E},    //    0xfb
+	{2, SET_7_H},    //    0xfc
+	{2, SET_7_L},    //    0xfd
+	{2, SET_7_HLp},  //    0xfe
+	{2, SET_7_A},    //    0xff
+};
+
+// Array storing the cycle length of each instruction / 2;
+const uint8_t Cycles[256] = {
+	4, 6, 4, 4, 2, 2, 4, 4, 10, 4, 4, 4, 2, 2, 4, 4,  // 0x0_
+	2, 6, 4, 4, 2, 2, 4, 4, 4,  4, 4, 4, 2, 2, 4, 4,  // 0x1_
+	0, 6, 4, 4, 2, 2, 4, 2, 0,  4, 4, 4, 2, 2, 4, 2,  // 0x2_
+	4, 6, 4, 4, 6, 6, 6, 2, 0,  4, 4, 4, 2, 2, 4, 2,  // 0x3_
+	2, 2, 2, 2, 2, 2, 4, 2, 2,  2, 2, 2, 2, 2, 4, 2,  // 0x4_
+	2, 2, 2, 2, 2, 2, 4, 2, 2,  2, 2, 2, 2, 2, 4, 2,  // 0x5_
+	2, 2, 2, 2, 2, 2, 4, 2, 2,  2, 2, 2, 2, 2, 4, 2,  // 0x6_
+	4, 4, 4, 4, 4, 4, 2, 4, 2,  2, 2, 2, 2, 2, 4, 2,  // 0x7_
+	2, 2, 2, 2, 2, 2, 4, 2, 2,  2, 2, 2, 2, 2, 4, 2,  // 0x8_
+	2, 2, 2, 2, 2, 2, 4, 2, 2,  2, 2, 2, 2, 2, 4, 2,  // 0x9_
+	2, 2, 2, 2, 2, 2, 4, 2, 2,  2, 2, 2, 2, 2, 4, 2,  // 0xa_
+	2, 2, 2, 2, 2, 2, 4, 2, 2,  2, 2, 2, 2, 2, 4, 2,  // 0xb_
+	0, 6, 0, 6, 0, 8, 4, 8, 0,  2, 0, 0, 0, 6, 4, 8,  // 0xc_
+	0, 6, 0, 0, 0, 8, 4, 8, 0,  8, 0, 0, 0, 0, 4, 8,  // 0xd_
+	6, 6, 4, 0, 0, 8, 4, 8, 8,  2, 8, 0, 0, 0, 4, 8,  // 0xe_
+	6, 6, 4, 2, 0, 8, 4, 8, 6,  4, 8, 2, 0, 0, 4, 8   // 0xf_
+};
+
+// Plain RAM for the single step tests, see FLAT_BUS in gameboy.h.
+#ifdef FLAT_BUS
+bus_access bus_log[BUS_LOG_SIZE];
+int bus_log_count = 0;
+
+uint8_t read_byte(uint16_t location) {
+	if (bus_log_count < BUS_LOG_SIZE) {
+		bus_log[bus_log_count++] = { location, memory[location], false };
+	}
+	return memory[location];
+}
+
+void write_byte(uint8_t data, uint16_t location) {
+	if (bus_log_count < BUS_LOG_SIZE) {
+		bus_log[bus_log_count++] = { location, data, true };
+	}
+	memory[location] = data;
+}
+#else
+uint8_t read_byte(uint16_t location) {
+	// If in Bootrom
+	if (enable_boot) {
+		if (location < 0x100) {
+			return boot_rom[location];
+		}
+	}
+
+	// Base Rom Read
+	if (location < 0x4000) {
+		return rom[location];
+	}
+
+	// Rom Bank Read
+	if (location < 0x8000) {
+		return rom[location + bank_offset * 0x4000];
+	}
+
+	// Key interupt.
+	if (location == 0xFF00) {
+		return key_state();
+	}
+
+	// Sound registers and wave RAM.
+	if (location >= 0xFF10 && location < 0xFF40) {
+		return read_apu(location);
+	}
+
+	// gameboy-doctor logs are made with LY stuck at 0x90.
+	if (location == 0xFF44 && doctor_enabled) {
+		return 0x90;
+	}
+	return memory[location];
+}
+
+void write_byte(uint8_t data, uint16_t location) {
+	// Rom Bank Set
+	if (location >= 0x2000 && location <= 0x3FFF) {
+		bank_offset = data - 1;
+	}
+
+	// Writing to read only memory
+	else if (location < 0x8000) {
+		return;
+	}
+
+	// Video RAM
+	else if (location < 0xA000) {
+		write_vram(data, location);
+	}
+
+	// Hardware registers
+	else if (location >= 0xFF00 && location < 0xFF80) {
+		write_io(data, location);
+	}
+
+	else {
+		memory[location] = data;
+	}
+}
+#endif
+
+int rom_bank(uint16_t location) {
+	if (location < 0x100 && enable_boot) {
+		return -1;
+	}
+	if (location >= 0x4000 && location < 0x8000) {
+		return (uint8_t)(bank_offset + 1);
+	}
+	return 0;
+}
+
+void write_vram(uint8_t data, uint16_t location) {
+	if (memory[location] == data) {
+		return;
+	}
+
+	ppu::before_vram_write();
+	memory[location] = data;
+	vram_version++;
+}
+
+void write_io(uint8_t data, uint16_t location) {
+	// Sound registers and wave RAM.
+	if (location >= 0xFF10 && location < 0xFF40) {
+		write_apu(data, location);
+		return;
+	}
+
+	switch (location) {
+	// Serial data and control
+	case 0xFF01:
+	case 0xFF02:
+		write_serial(data, location);
+		break;
+
+	// Reset the divider register
+	case 0xFF04:
+		memory[0xFF04] = 0;
+		divider_count = 0;
+		break;
+
+	// LCD control
+	case 0xFF40:
+		memory[0xFF40] = data;
+		if (test_bit(7, data) != lcd_enabled) {
+			set_lcd_enabled(test_bit(7, data));
+		}
+		break;
+
+	// LCD status, only the interupt select bits are writable
+	case 0xFF41:
+		memory[0xFF41] = 0x80 | (data & 0x78) | (memory[0xFF41] & 0x07);
+		update_stat_interupt();
+		break;
+
+	// Reset scanline count
+	case 0xFF44:
+		memory[0xFF44] = 0;
+		check_coincidence();
+		update_stat_interupt();
+		break;
+
+	// LY compare
+	case 0xFF45:
+		memory[0xFF45] = data;
+		check_coincidence();
+		update_stat_interupt();
+		break;
+
+	// Execute DMA
+	case 0xFF46:
+		dma_transfer(data);
+		break;
+
+	// Palettes
+	case 0xFF47:
+		memory[0xFF47] = data;
+		bg_palette = palette_table[data];
+		break;
+
+	case 0xFF48:
+		memory[0xFF48] = data;
+		obj_palette[0] = palette_table[data];
+		break;
+
+	case 0xFF49:
+		memory[0xFF49] = data;
+		obj_palette[1] = palette_table[data];
+		break;
+
+	default:
+		memory[location] = data;
+		break;
+	}
+}
+
+void measure_tick_overhead() {
+	tick_overhead = UINT64_MAX;
+	for (int i = 0; i < 1000; i++) {
+		uint64_t start = __rdtsc();
+		uint64_t spent = __rdtsc() - start;
+		if (spent < tick_overhead) {
+			tick_overhead = spent;
+		}
+	}
+}
+
+// Adds the time stamp counter ticks since start, less the cost of reading
+// the counter, to part and starts counting again from now.
+inline void charge_time(subsystem part, uint64_t& start) {
+	uint64_t now = __rdtsc();
+	uint64_t spent = now - start;
+	subsystem_time[part] += spent > tick_overhead ? spent - tick_overhead : 0;
+	start = now;
+}
+
+#ifdef TIMELINE
+void record_subsystem_shares() {
+	static const char* const names[SUBSYSTEMS] = { "cpu", "timers", "ppu", "interupts", "apu" };
+	static uint64_t previous[SUBSYSTEMS];
+	uint64_t spent[SUBSYSTEMS];
+	uint64_t total = 0;
+	for (int i = 0; i < SUBSYSTEMS; i++) {
+		spent[i] = subsystem_time[i] - previous[i];
+		previous[i] = subsystem_time[i];
+		total += spent[i];
+	}
+	double shares[SUBSYSTEMS];
+	for (int i = 0; i < SUBSYSTEMS; i++) {
+		shares[i] = total ? 100.0 * spent[i] / total : 0.0;
+	}
+	TIMELINE_COUNTER("subsystems %", names, shares, SUBSYSTEMS);
+}
+#endif
+
+// Timed is a template argument so the normal loop has no timing code in it
+// at all.
+template <typename Ppu, bool Timed>
+void run_frame() {
+	cycle_count = 0;
+	uint64_t start = Timed ? __rdtsc() : 0;
+	while (cycle_count < CYCLES_PER_FRAME) {
+		if (registers.pc == 0x100) {
+			enable_boot = false;
+		}
+		cpu_cycle();
+		if (core_stopped) {
+			break;
+		}
+		instruction_count++;
+		if (Timed) charge_time(SUBSYSTEM_CPU, start);
+		update_timers();
+		if (emulated_cycles + cycle_count >= serial_deadline) {
+			serial_event();
+		}
+		if (emulated_cycles + cycle_count >= pc_sample_deadline) {
+			sample_pc(registers.pc, rom_bank(registers.pc));
+		}
+		if (Timed) charge_time(SUBSYSTEM_TIMERS, start);
+		Ppu::step();
+		if (Timed) charge_time(SUBSYSTEM_PPU, start);
+		interupts();
+		if (Timed) charge_time(SUBSYSTEM_INTERUPTS, start);
+	}
+	end_apu_frame();
+	if (Timed) charge_time(SUBSYSTEM_APU, start);
+	emulated_cycles += cycle_count;
+}
+
+void emulate_frame() {
+	TIMELINE_SCOPE("emulate_frame");
+	if (subsystem_timing_enabled) {
+		run_frame<ppu, true>();
+	}
+	else {
+		run_frame<ppu, false>();
+	}
+}
+
+void stop_core() {
+	core_stopped = true;
+	emulation_running = false;
+}
+
+void run_emulation() {
+	// Frames are paced against the clock here rather than by the display, so
+	// a slow present on the front end never changes emulation speed.
+	const chrono::steady_clock::duration frame_time =
+		chrono::duration_cast<chrono::steady_clock::duration>(
+			chrono::duration<double>((double)CYCLES_PER_FRAME / CLOCKSPEED));
+	chrono::steady_clock::time_point next_frame = chrono::steady_clock::now();
+
+	ppu::start();
+	if (subsystem_timing_enabled) {
+		measure_tick_overhead();
+	}
+
+	TIMELINE_THREAD("core");
+	registers.pc = 0;
+	while (emulation_running) {
+		process_input();
+		emulate_frame();
+#ifdef TIMELINE
+		if (subsystem_timing_enabled) {
+			record_subsystem_shares();
+		}
+		if (timeline_write_requested.exchange(false)) {
+			write_timeline();
+		}
+#endif
+#ifdef OPCODE_PROFILE
+		if (profile_dump_requested.exchange(false)) {
+			write_opcode_profile();
+		}
+#endif
+
+		frame_count++;
+		if (frame_limit && frame_count >= frame_limit) {
+			emulation_running = false;
+			break;
+		}
+		if (!throttle_enabled) {
+			continue;
+		}
+
+		next_frame += frame_time;
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		if (now > next_frame + 4 * frame_time) {
+			// Too far behind to catch up (debugger, suspend), start again from now.
+			next_frame = now;
+		}
+		TIMELINE_SCOPE("throttle");
+		this_thread::sleep_until(next_frame);
+	}
+
+	ppu::stop();
+}
+
+// Only a subtraction and a compare per instruction. Everything else happens
+// in ppu_event() at the point where the mode actually changes.
+void increment_scan_line() {
+	if (!lcd_enabled) {
+		return;
+	}
+
+	scanline_count -= last_cycles;
+	while (scanline_count <= ppu_deadline) {
+		ppu_event();
+	}
+}
+
+void ppu_event() {
+	switch (ppu_mode) {
+	// OAM search (80 cycles) done, start transferring to the LCD.
+	case 2:
+		set_ppu_mode(3, 204);
+		break;
+
+	// Transfer (172 cycles) done, log the line and enter HBLANK.
+	case 3:
+		log_line();
+		set_ppu_mode(0, 0);
+		break;
+
+	// End of line.
+	case 0:
+	case 1:
+		scanline_count += 456;
+		memory[0xFF44]++;
+		// Check if all lines are finished and if so do a VBLANK.
+		if (memory[0xFF44] == 144) {
+			set_ppu_mode(1, 0);
+			submit_frame(memory + 0x8000, memory + 0xFE00, line_log, lines_drawn, emulated_cycles + cycle_count);
+			lines_logged = 0;
+			lines_drawn = 0;
+			set_interupt(0);
+		}
+		// Reset scanline once it reaches the end.
+		else if (memory[0xFF44] > 153) {
+			memory[0xFF44] = 0;
+			set_ppu_mode(2, 376);
+		}
+		else if (memory[0xFF44] < 144) {
+			set_ppu_mode(2, 376);
+		}
+		check_coincidence();
+		break;
+	}
+	update_stat_interupt();
+}
+
+void log_line() {
+	uint8_t currentline = memory[0xFF44];
+	line_registers& regs = line_log[currentline];
+	regs.lcdc = memory[0xFF40];
+	regs.scroll_y = memory[0xFF42];
+	regs.scroll_x = memory[0xFF43];
+	regs.window_y = memory[0xFF4A];
+	regs.window_x = memory[0xFF4B];
+	regs.bg_palette = bg_palette;
+	regs.obj_palette[0] = obj_palette[0];
+	regs.obj_palette[1] = obj_palette[1];
+	regs.vram_version = vram_version;
+	lines_logged = currentline + 1;
+}
+
+void flush_lines() {
+	wait_for_renderer();
+	render_lines(memory + 0x8000, line_log, lines_drawn, lines_logged);
+	lines_drawn = lines_logged;
+}
+
+void set_ppu_mode(uint8_t mode, int deadline) {
+	ppu_mode = mode;
+	ppu_deadline = deadline;
+	memory[0xFF41] = (memory[0xFF41] & 0xFC) | mode;
+}
+
+void set_lcd_enabled(bool enabled) {
+	lcd_enabled = enabled;
+	memory[0xFF44] = 0;
+	scanline_count = 456;
+	ppu::start_frame();
+	if (enabled) {
+		set_ppu_mode(2, 376);
+		check_coincidence();
+	}
+	else {
+		// Mode 0 while the lcd is off, no interupts. The partial frame is dropped.
+		set_ppu_mode(0, 0);
+		stat_line = false;
+		lines_logged = 0;
+		lines_drawn = 0;
+		return;
+	}
+	update_stat_interupt();
+}
+
+void check_coincidence() {
+	if (memory[0xFF44] == memory[0xFF45]) {
+		memory[0xFF41] = Set(2, memory[0xFF41]);
+	}
+	else {
+		memory[0xFF41] = Res(2, memory[0xFF41]);
+	}
+}
+
+void update_stat_interupt() {
+	uint8_t status = memory[0xFF41];
+	bool line = (test_bit(6, status) && test_bit(2, status)) ||
+		(test_bit(5, status) && ppu_mode == 2) ||
+		(test_bit(4, status) && ppu_mode == 1) ||
+		(test_bit(3, status) && ppu_mode == 0);
+
+	if (line && !stat_line && lcd_enabled) {
+		set_interupt(1);
+	}
+	stat_line = line;
+}
+
+void key_press(int key) {
+	bool previouslyUnset = false;
+
+	if (!test_bit(key, joypad_state)) {
+		previouslyUnset = true;
+	}
+
+	joypad_state = Res(key, joypad_state);
+
+	// Standard or directional button?
+	bool button = key > 3;
+
+	// Check which keys game is interested in and perform interupts
+	bool request_interupt = false;
+	if (button && !test_bit(5, read_byte(0xFF00))) {
+		request_interupt = true;
+	}
+	else if (!button && !test_bit(4, read_byte(0xFF00))) {
+		request_interupt = true;
+	}
+
+	if (request_interupt && !previouslyUnset) set_interupt(4);
+}
+
+void key_release(int key) { joypad_state = Set(key, joypad_state); }
+
+void process_input() {
+	if (color_scheme != active_color_scheme) {
+		set_color_scheme(color_scheme);
+	}
+
+	input_event input;
+	while (input_queue.pop(input)) {
+		if (input.pressed) {
+			key_press(input.key);
+		}
+		else {
+			key_release(input.key);
+		}
+	}
+
+	while (movie_position < movie.size() && movie[movie_position].frame <= frame_count) {
+		if (movie[movie_position].pressed) {
+			key_press(movie[movie_position].key);
+		}
+		else {
+			key_release(movie[movie_position].key);
+		}
+		movie_position++;
+	}
+}
+
+uint8_t key_state() {
+	uint8_t res = memory[0xFF00];
+	res ^= 0xFF;
+
+	// Are we interested in the standard buttons?
+	if (!test_bit(4, res)) {
+		BYTE topJoypad = joypad_state >> 4;
+		topJoypad |= 0xF0;  // turn the top 4 bits on
+		res &= topJoypad;   // show what buttons are pressed
+	}
+	// Or directional buttons?
+	else if (!test_bit(5, res))  // directional buttons
+	{
+		BYTE bottomJoypad = joypad_state & 0xF;
+		bottomJoypad |= 0xF0;
+		res &= bottomJoypad;
+	}
+	return res;
+}
+
+void update_timers() {
+	// Update Divider Register
+	divider_count += last_cycles;
+	if (divider_count >= 256) {
+		divider_count = 0;
+		memory[0xFF04] = read_byte(0xFF04) + 1;
+	}
+
+	// Update Main Timer Clock Speed
+	switch (read_byte(0xFF07) & 0x3) {
+	case 0:
+		curr_clock_speed = 1024;
+		break;
+	case 1:
+		curr_clock_speed = 16;
+		break;
+	case 2:
+		curr_clock_speed = 64;
+		break;
+	case 3:
+		curr_clock_speed = 256;
+		break;
+	}
+
+	// Tick Main Timer
+	if (test_bit(2, read_byte(0xFF07))) {
+		timer_count += last_cycles;
+
+		if (timer_count >= curr_clock_speed) {
+			timer_count = 0;
+			write_byte(read_byte(0xFF05) + 1, 0xFF05);
+
+			if (read_byte(0xFF05) == 0xFF) {
+				write_byte(read_byte(0xFF06), 0xFF05);
+				set_interupt(2);
+			}
+		}
+	}
+}
+
+void setup_color_palettes() {
+	for (int scheme = 0; scheme < COLOR_SCHEMES; scheme++) {
+		for (int value = 0; value < 256; value++) {
+			for (int i = 0; i < 4; i++) {
+				palette_tables[scheme][value][i] = color_schemes[scheme][(value >> 2 * i) & 0x3];
+			}
+		}
+	}
+	set_color_scheme(color_scheme);
+}
+
+void set_color_scheme(int scheme) {
+	active_color_scheme = scheme;
+	palette_table = palette_tables[scheme];
+	bg_palette = palette_table[memory[0xFF47]];
+	obj_palette[0] = palette_table[memory[0xFF48]];
+	obj_palette[1] = palette_table[memory[0xFF49]];
+}
+
+void read_rom(char* filename) {
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		cerr << "Invalid Rom File!" << endl;
+		exit(1);
+	}
+	std::streamsize size = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	std::vector<char> buffer(size);
+	rom = (uint8_t*)malloc(size * sizeof(uint8_t));
+	if (file.read(buffer.data(), size)) {
+		for (auto i = 0; i < size; ++i) {
+			rom[i] = (uint8_t)buffer[i];
+		}
+		cout << "Loaded " << filename << endl;
+	}
+	else {
+		cerr << "Invalid Rom File!" << endl;
+		exit(1);
+	}
+}
+
+void load_bootrom(char* filename) {
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		cerr << "Invalid Bootrom File!" << endl;
+		exit(1);
+	}
+
+	std::streamsize size = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	std::vector<char> buffer(size);
+	boot_rom = (uint8_t*)malloc(size * sizeof(uint8_t));
+	if (file.read(buffer.data(), size)) {
+		cout << "Loaded " << filename << endl;
+		for (int i = 0; i < size; ++i) {
+			boot_rom[i] = (uint8_t)buffer[i];
+		}
+	}
+	else {
+		cerr << "Invalid Bootrom File!" << endl;
+		exit(1);
+	}
+}
+
+// One key change per line: "<frame> <button> <down|up>". Buttons are right,
+// left, up, down, a, b, select and start. Lines starting with # are skipped.
+void load_movie(char* filename) {
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		cerr << "Invalid Movie File!" << endl;
+		exit(1);
+	}
+
+	const char* buttons[8] = { "right", "left", "up", "down", "a", "b", "select", "start" };
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		movie_event event;
+		char button[16];
+		char state[8];
+		if (sscanf(line.c_str(), "%d %15s %7s", &event.frame, button, state) != 3) {
+			cerr << "Invalid Movie Line: " << line << endl;
+			exit(1);
+		}
+
+		event.key = -1;
+		for (int i = 0; i < 8; i++) {
+			if (!strcmp(button, buttons[i])) {
+				event.key = i;
+			}
+		}
+		event.pressed = !strcmp(state, "down");
+		if (event.key == -1 || (!event.pressed && strcmp(state, "up"))) {
+			cerr << "Invalid Movie Line: " << line << endl;
+			exit(1);
+		}
+		movie.push_back(event);
+	}
+
+	std::stable_sort(movie.begin(), movie.end(),
+		[](const movie_event& a, const movie_event& b) { return a.frame < b.frame; });
+	cout << "Loaded " << filename << endl;
+}
+
+void dma_transfer(uint8_t data) {
+	uint16_t address = data << 8;
+	for (int i = 0; i < 0xA0; i++) {
+		write_byte(read_byte(address + i), 0xFE00 + i);
+	}
+}
+
+void detect_banking_mode() {
+	switch (rom[0x147]) {
+	case 1:
+		mbc1 = true;
+		break;
+	case 2:
+		mbc1 = true;
+		break;
+	case 3:
+		mbc1 = true;
+		break;
+	case 5:
+		mbc2 = true;
+		break;
+	case 6:
+		mbc2 = true;
+		break;
+	default:
+		break;
+	}
+
+	if (mbc1) {
+		cout << "Using MBC1" << endl;
+	}
+
+	if (mbc2) {
+		cout << "Using MBC2" << endl;
+	}
+
+	printf("Number of RAM banks: %d\n", rom[0x148]);
+}
+
+cpu_state get_cpu_state() {
+	cpu_state state;
+	state.a = registers.a;
+	state.f = registers.f;
+	state.b = registers.b;
+	state.c = registers.c;
+	state.d = registers.d;
+	state.e = registers.e;
+	state.h = registers.h;
+	state.l = registers.l;
+	state.sp = registers.sp;
+	state.pc = registers.pc;
+	state.ime = IME;
+	return state;
+}
+
+void set_cpu_state(const cpu_state& state) {
+	registers.a = state.a;
+	registers.f = state.f;
+	registers.b = state.b;
+	registers.c = state.c;
+	registers.d = state.d;
+	registers.e = state.e;
+	registers.h = state.h;
+	registers.l = state.l;
+	registers.sp = state.sp;
+	registers.pc = state.pc;
+	IME = state.ime;
+}
+
+bool mooneye_passed() {
+	return registers.b == 3 && registers.c == 5 && registers.d == 8 && registers.e == 13 &&
+		registers.h == 21 && registers.l == 34;
+}
+
+bool mooneye_failed() {
+	return registers.b == 0x42 && registers.c == 0x42 && registers.d == 0x42 && registers.e == 0x42 &&
+		registers.h == 0x42 && registers.l == 0x42;
+}
+
+// Used for Debugging. (Prints out Registers)
+void print_registers() {
+	printf("af: %04x \n", registers.af);
+	printf("bc: %04x \n", registers.bc);
+	printf("de: %04x \n", registers.de);
+	printf("hl: %04x \n", registers.hl);
+	printf("sp: %04x \n", registers.sp);
+	printf("pc: %04x \n", registers.pc);
+	printf("Stack Value: %04x \n",
+		((memory[registers.sp] << 8) | memory[registers.sp + 1]));
+	printf("0x%x: %s ", registers.pc, instruction_name(read_byte(registers.pc), false));
+	printf("(0x%x)\n", read_byte(registers.pc));
+	printf("IME: %x\n", IME);
+	printf("operand16: %04x \n", Operand16);
+	printf("operand8: %02x \n", Operand8);
+}
+
+void cpu_cycle() {
+	uint8_t opcode = read_byte(registers.pc);
+	if (trace_enabled) {
+		trace_instruction(opcode);
+	}
+	if (doctor_enabled && !enable_boot) {
+		doctor_instruction();
+		if (core_stopped) {
+			return;  // Diverged, leave the state as the log line shows it.
+		}
+	}
+
+	if (instructions[opcode].length == 0) {
+		registers.pc += 1;
+		((void (*)(void))instructions[opcode].fcnPtr)();
+	}
+	else if (instructions[opcode].length == 1) {
+		registers.pc += 1;
+		((void (*)(void))instructions[opcode].fcnPtr)();
+	}
+	else if (instructions[opcode].length == 2) {
+		Operand8 = read_byte(registers.pc + 1);
+		registers.pc += 2;
+		if (opcode == 0xCB) {
+			((void (*)(void))CB_instructions[Operand8].fcnPtr)();
+		}
+		else {
+			((void (*)(void))instructions[opcode].fcnPtr)();
+		}
+	}
+	else if (instructions[opcode].length == 3) {
+		Operand16 =
+			(read_byte(registers.pc + 2) << 8) + read_byte(registers.pc + 1);
+		registers.pc += 3;
+		((void (*)(void))instructions[opcode].fcnPtr)();
+	}
+
+	cycle_count += 2 * Cycles[opcode];
+	last_cycles = 2 * Cycles[opcode];
+#ifdef OPCODE_PROFILE
+	profile_opcode(opcode == 0xCB ? 0x100 + Operand8 : opcode, last_cycles);
+#endif
+}
+
+void trace_instruction(uint8_t opcode) {
+	trace_record& record = next_trace_record(emulated_cycles + cycle_count);
+	record.pc = registers.pc;
+	record.bank = (uint8_t)rom_bank(registers.pc);
+	record.opcode = opcode;
+	record.a = registers.a;
+	record.f = registers.f;
+	record.b = registers.b;
+	record.c = registers.c;
+	record.d = registers.d;
+	record.e = registers.e;
+	record.h = registers.h;
+	record.l = registers.l;
+	record.sp = registers.sp;
+}
+
+void doctor_instruction() {
+	const char digits[] = "0123456789ABCDEF";
+	char line[DOCTOR_LINE_LENGTH + 1] = "A:00 F:00 B:00 C:00 D:00 E:00 H:00 L:00 SP:0000 PC:0000 PCMEM:00,00,00,00";
+	uint8_t bytes[] = { registers.a, registers.f, registers.b, registers.c, registers.d, registers.e, registers.h, registers.l,
+		(uint8_t)(registers.sp >> 8), (uint8_t)registers.sp, (uint8_t)(registers.pc >> 8), (uint8_t)registers.pc,
+		read_byte(registers.pc), read_byte(registers.pc + 1), read_byte(registers.pc + 2), read_byte(registers.pc + 3) };
+	const int positions[] = { 2, 7, 12, 17, 22, 27, 32, 37, 43, 45, 51, 53, 62, 65, 68, 71 };
+	for (int i = 0; i < 16; i++) {
+		line[positions[i]] = digits[bytes[i] >> 4];
+		line[positions[i] + 1] = digits[bytes[i] & 0xF];
+	}
+	compare_doctor_line(line);
+}
+
+void interupts() {
+	if (IME) {
+		uint8_t request_flag = read_byte(0xFF0F);
+		if (read_byte(0xFF0F)) {
+			for (int bit = 0; bit < 8; bit++) {
+				if (request_flag & (0x1 << bit)) {
+					if (read_byte(0xFFFF) & (0x1 << bit)) {
+						do_interupt(bit);
+					}
+				}
+			}
+		}
+	}
+}
+
+void do_interupt(uint8_t interupt) {
+	IME = 0;
+	write_byte(Res(interupt, read_byte(0xFF0F)), 0xFF0F);
+
+	switch (interupt) {
+	case 0:
+		Call(0x40);
+		break;
+	case 1:
+		Call(0x48);
+		break;
+	case 2:
+		Call(0x50);
+		break;
+	case 3:
+		Call(0x58);
+		break;
+	case 4:
+		Call(0x60);
+		break;
+	}
+}
+
+void set_interupt(uint8_t interupt) {
+	write_byte(Set(interupt, read_byte(0xFF0F)), 0xFF0F);
+}
+
+// Functions to Set Flags.
+void Set_Z_Flag() { 
+	registers.f = registers.f | 0x80;
+}
+
+void Set_N_Flag() {
+	registers.f = registers.f | 0x40;
+}
+
+void Set_H_Flag() { 
+	registers.f = registers.f | 0x20;
+}
+
+void Set_C_Flag() {
+	registers.f = registers.f | 0x10; 
+}
+
+void Clear_Z_Flag() { 
+	registers.f = registers.f & 0x7F; 
+}
+
+void Clear_N_Flag() { 
+	registers.f = registers.f & 0xBF; 
+}
+
+void Clear_H_Flag() {
+	registers.f = registers.f & 0xDF; 
+}
+
+void Clear_C_Flag() {
+	registers.f = registers.f & 0xEF; 
+}
+
+// Normal rotates (Set carry flag).
+uint8_t RotByteLeft(uint8_t number) {
+	uint8_t carry = number & 0x80;
+	number = (number << 1) | (carry >> 7);
+	if (carry) {
+		Set_C_Flag();
+	}  // Set Carry flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	if (number) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	Clear_N_Flag();  // Clear Negative and Half Carry flags.
+	Clear_H_Flag();
+
+	return number;
+}
+
+uint8_t RotByteRight(uint8_t number) {
+	uint8_t carry = number & 0x1;
+	number = (number >> 1) | (carry << 7);
+	if (carry) {
+		Set_C_Flag();
+	}  // Set Carry flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	if (number) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	Clear_N_Flag();  // Clear Negative and Half Carry flags.
+	Clear_H_Flag();
+
+	return number;
+}
+
+// Rotates through Carry.
+uint8_t Rotate_Right_Carry(uint8_t number) {
+	uint8_t carry = (number & 0x01);
+	number >>= 1;              // Shift right 1 bit.
+	if (registers.f & 0x10) {  // Check if Carry flag is Set.
+		number += 0x80;
+	}
+
+	if (carry) {
+		Set_C_Flag();
+	}  // Set Carry flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	if (number) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	// Clear other flags.
+	Clear_N_Flag();
+	Clear_H_Flag();
+	return number;
+}
+
+uint8_t Rotate_Left_Carry(uint8_t number) {
+	uint8_t carry = (number & 0x80);
+
+	number <<= 1;
+
+	if (registers.f & 0x10) {  // Check if Carry flag is Set.
+		number++;
+	}
+
+	if (carry)
+		Set_C_Flag();  // Set Carry flag.
+	else
+		Clear_C_Flag();
+
+	if (number) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	// Clear other flags.
+	Clear_N_Flag();
+	Clear_H_Flag();
+	return number;
+}
+
+// Shifts.
+uint8_t Shift_Left(uint8_t number) {
+	if (number & 0x80) {
+		Set_C_Flag();
+	}  // Set Carry flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	number <<= 1;
+
+	if (number) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	Clear_N_Flag();  // Clear Negative and Half Carry flags.
+	Clear_H_Flag();
+
+	return number;
+}
+
+uint8_t Shift_Right(uint8_t number) {
+	if (number & 0x1) {
+		Set_C_Flag();
+	}  // Set Carry flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	number >>= 1;
+
+	if (number) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	Clear_N_Flag();  // Clear Negative and Half Carry flags.
+	Clear_H_Flag();
+
+	return number;
+}
+
+uint8_t Shift_Right_A(uint8_t number) {
+	if (number & 0x1) {
+		Set_C_Flag();
+	}  // Set Carry flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	number = (number >> 1) | (number % 0x80);
+
+	if (number) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	Clear_N_Flag();  // Clear Negative and Half Carry flags.
+	Clear_H_Flag();
+
+	return number;
+}
+
+// Swap.
+uint8_t Swap(uint8_t number) {
+	number = ((number & 0xf0) >> 4) | ((number & 0x0f) << 4);  // Swap.
+
+	if (number) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	Clear_H_Flag();
+	Clear_N_Flag();
+	Clear_C_Flag();
+
+	return number;
+}
+
+// Add and sub.
+void add_byte(uint8_t Value2) {
+	int result = registers.a + Value2;
+
+	if ((((registers.a & 0xf) + (Value2 & 0xf)) > 0x0f)) {
+		Set_H_Flag();
+	}  // Set Half Carry Flag.
+	else {
+		Clear_H_Flag();
+	}
+
+	if (result & 0xff00) {
+		Set_C_Flag();
+	}  // Set Full Carry Flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	Clear_N_Flag();  // Clear Negative Flag.
+
+	registers.a = (uint8_t)(result & 0xff);
+
+	if (registers.a)
+		Clear_Z_Flag();  // Set Zero Flag.
+	else
+		Set_Z_Flag();
+}
+
+uint16_t add_2_byte(uint16_t Value1, uint16_t Value2) {
+	unsigned long result = Value1 + Value2;
+
+	if ((((Value1 & 0xff) + (Value2 & 0xff)) > 0xff)) {
+		Set_H_Flag();
+	}  // Set Half Carry Flag.
+	else {
+		Clear_H_Flag();
+	}
+
+	if (result & 0xffff0000) {
+		Set_C_Flag();
+	}  // Set Full Carry Flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	Clear_N_Flag();  // Clear Negative Flag.
+
+	return (uint16_t)(result & 0xffff);  // Return 16 bytes.
+}
+
+void sub_byte(uint8_t value) {
+	Set_N_Flag();
+
+	if (value > registers.a) {
+		Set_C_Flag();
+	}  // Set Carry flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	if ((value & 0x0f) > (registers.a & 0x0f)) {
+		Set_H_Flag();
+	}  // Set Half Carry Flag.
+	else {
+		Clear_H_Flag();
+	}
+
+	registers.a -= value;  // Do Sub.
+
+	if (registers.a)
+		Clear_Z_Flag();  // Set Zero Flag.
+	else
+		Set_Z_Flag();
+}
+
+// Does Subtraction only setting flags.
+void cp(uint8_t value) {
+	Set_N_Flag();
+
+	if (value > registers.a) {
+		Set_C_Flag();
+	}  // Set Carry flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	if ((value & 0x0f) > (registers.a & 0x0f)) {
+		Set_H_Flag();
+	}  // Set Half Carry Flag.
+	else {
+		Clear_H_Flag();
+	}
+
+	if (registers.a == value)
+		Set_Z_Flag();  // Set Zero Flag.
+	else
+		Clear_Z_Flag();
+}
+
+void adc(uint8_t a) {
+	Clear_N_Flag();
+	int value = a;
+	if (registers.f & 0x10) {
+		value++;
+	}  // Adds Carry.
+
+	int result = registers.a + value;  // Do addition.
+
+	if (result & 0xff00) {
+		Set_C_Flag();
+	}  // Check Carry.
+	else {
+		Clear_C_Flag();
+	}
+
+	if (((result & 0x0f) + (registers.a & 0x0f)) > 0x0f) {
+		Set_H_Flag();
+	}  // Check Half Carry.
+	else {
+		Clear_H_Flag();
+	}
+
+	registers.a = (uint8_t)(result & 0xff);  // Set a to addition (8 bytes)
+}
+
+void Sbc(uint8_t value) {
+	if (registers.f & 0x10) {
+		value++;
+	}  // Adds Carry.
+
+	Set_N_Flag();  // Set Negative Flag.
+
+	if (value > registers.a) {
+		Set_C_Flag();
+	}  // Set Carry flag.
+	else {
+		Clear_C_Flag();
+	}
+
+	if ((value & 0x0f) > (registers.a & 0x0f)) {
+		Set_H_Flag();
+	}  // Set Half Carry Flag.
+	else {
+		Clear_H_Flag();
+	}
+
+	registers.a -= value;  // Do Sub.
+
+	if (registers.a)
+		Clear_Z_Flag();  // Set Zero Flag.
+	else
+		Set_Z_Flag();
+}
+
+uint8_t inc(uint8_t value) {
+	if ((value & 0xf) == 0xf) {
+		Set_H_Flag();
+	}
+	else {
+		Clear_H_Flag();
+	}
+
+	value++;
+
+	if (value) {
+		Clear_Z_Flag();
+	}
+	else {
+		Set_Z_Flag();
+	}
+
+	Clear_N_Flag();
+	return value;
+}
+
+uint8_t dec(uint8_t value) {
+	if (value & 0xf) {
+		Clear_H_Flag();
+	}
+	else {
+		Set_H_Flag();
+	}
+
+	value--;
+
+	if (value) {
+		Clear_Z_Flag();
+	}
+	else {
+		Set_Z_Flag();
+	}
+
+	Set_N_Flag();
+	return value;
+}
+
+void And(uint8_t a) {
+	registers.a = a & registers.a;
+
+	if (registers.a) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	Set_H_Flag();  // Clear Flags. Set H Flag.
+	Clear_N_Flag();
+	Clear_C_Flag();
+}
+
+void Or(uint8_t a) {
+	registers.a |= a;
+
+	if (registers.a) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	Clear_N_Flag();  // Clear Other Flags.
+	Clear_H_Flag();
+	Clear_C_Flag();
+}
+
+void Xor(uint8_t a) {
+	registers.a ^= a;
+
+	if (registers.a) {
+		Clear_Z_Flag();
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+	}
+
+	Clear_N_Flag();  // Clear Other Flags.
+	Clear_H_Flag();
+	Clear_C_Flag();
+}
+
+// Bit test.
+uint8_t Bit_Test(uint8_t bit, uint8_t number) {
+	uint8_t bitindex = 0x1 << bit;
+	Clear_N_Flag();
+	Set_H_Flag();
+	if (number & bitindex) {
+		Clear_Z_Flag();
+		return 1;
+	}  // Set Zero Flag.
+	else {
+		Set_Z_Flag();
+		return 0;
+	}
+}
+
+uint8_t test_bit(uint8_t bit, uint8_t number) {
+	uint8_t bitindex = 0x1 << bit;
+	if (number & bitindex) {
+		return 1;
+	}  // Set Zero Flag.
+	else {
+		return 0;
+	}
+}
+
+// Bit sets.
+// Set bit 0.
+uint8_t Res(uint8_t bit, uint8_t number) {
+	uint8_t bitindex = 0x1 << bit;
+	return number & (0xFF ^ bitindex);  // Set Zero Flag.
+}
+
+// Set bit 1.
+uint8_t Set(uint8_t bit, uint8_t number) {
+	uint8_t bitindex = 0x1 << bit;
+	return (number | bitindex);
+}
+
+// Stack Instructions.
+void Push(uint16_t a) {
+	registers.sp -= 2;
+	write_byte((uint8_t)((a >> 8) & 0x00FF), registers.sp);
+	write_byte((uint8_t)(a & 0x00FF), registers.sp + 1);
+}
+
+uint16_t Pop() {
+	uint16_t a;
+	a = (read_byte(registers.sp) << 8) + read_byte(registers.sp + 1);
+	registers.sp += 2;
+	return a;
+}
+
+void Call(uint16_t a) {
+	if (call_stack_enabled) {
+		shadow_call(registers.pc, registers.sp, a, rom_bank(a), emulated_cycles + cycle_count);
+	}
+	Push(registers.pc);
+	registers.pc = a;
+}
+
+void Return() {
+	uint16_t sp = registers.sp;
+	registers.pc = Pop();
+	if (call_stack_enabled) {
+		shadow_return(registers.pc, sp, emulated_cycles + cycle_count);
+	}
+}
+
+// Instruction Implementations.
+void NOP()  //    0x0
+{}
+void LD_BC_d16()  //    0x1
+{
+	registers.bc = Operand16;
+}
+void LD_BCp_A()  //    0x2
+{
+	write_byte(registers.a, registers.bc);
+}
+void INC_BC()  //    0x3
+{
+	registers.bc++;
+}
+void INC_B()  //    0x4
+{
+	registers.b = inc(registers.b);
+}
+void DEC_B()  //    0x5
+{
+	registers.b = dec(registers.b);
+}
+void LD_B_d8()  //    0x6
+{
+	registers.b = Operand8;
+}
+void RLCA()  //    0x7
+{
+	registers.a = RotByteLeft(registers.a);
+	Clear_Z_Flag();
+}
+void LD_a16p_SP()  //    0x8
+{
+	write_byte((uint8_t)(registers.sp & 0x00FF), Operand16);
+	write_byte((uint8_t)((registers.sp >> 8) & 0x00FF), Operand16 + 1);
+}
+void ADD_HL_BC()  //    0x9
+{
+	registers.hl = add_2_byte(registers.hl, registers.bc);
+}
+void LD_A_BCp()  //    0xa
+{
+	registers.a = read_byte(registers.bc);
+}
+void DEC_BC()  //    0xb
+{
+	registers.bc--;
+}
+void INC_C()  //    0xc
+{
+	registers.c = inc(registers.c);
+}
+void DEC_C()  //    0xd
+{
+	registers.c = dec(registers.c);
+}
+void LD_C_d8()  //    0xe
+{
+	registers.c = Operand8;
+}
+void RRCA()  //    0xf
+{
+	registers.a = RotByteRight(registers.a);
+	Clear_Z_Flag();
+}
+void STOP_0()  //    0x10
+{
+	printf("Unimplemented Instruction!!, STOP\n");
+}
+void LD_DE_d16()  //    0x11
+{
+	registers.de = Operand16;
+}
+void LD_DEp_A()  //    0x12
+{
+	write_byte(registers.a, registers.de);
+}
+void INC_DE()  //    0x13
+{
+	registers.de++;
+}
+void INC_D()  //    0x14
+{
+	registers.d = inc(registers.d);
+}
+void DEC_D()  //    0x15
+{
+	registers.d = dec(registers.d);
+}
+void LD_D_d8()  //    0x16
+{
+	registers.d = Operand8;
+}
+void RLA()  //    0x17
+{
+	registers.a = Rotate_Left_Carry(registers.a);
+	Clear_Z_Flag();
+}
+void JR_r8()  //    0x18
+{
+	registers.pc += (signed char)Operand8;
+}
+void ADD_HL_DE()  //    0x19
+{
+	registers.hl = add_2_byte(registers.hl, registers.de);
+}
+void LD_A_DEp()  //    0x1a
+{
+	registers.a = read_byte(registers.de);
+}
+void DEC_DE()  //    0x1b
+{
+	registers.de--;
+}
+void INC_E()  //    0x1c
+{
+	registers.e = inc(registers.e);
+}
+void DEC_E()  //    0x1d
+{
+	registers.e = dec(registers.e);
+}
+void LD_E_d8()  //    0x1e
+{
+	registers.e = Operand8;
+}
+void RRA()  //    0x1f
+{
+	registers.a = Rotate_Right_Carry(registers.a);
+	Clear_Z_Flag();
+}
+void JR_NZ_r8()  //    0x20
+{
+	if ((registers.f & 0x80) == 0x00) {
+		registers.pc += (signed char)Operand8;
+	}
+}
+void LD_HL_d16()  //    0x21
+{
+	registers.hl = Operand16;
+}
+void LD_HLIp_A()  //    0x22
+{
+	write_byte(registers.a, registers.hl);
+	registers.hl++;
+}
+void INC_HL()  //    0x23
+{
+	registers.hl++;
+}
+void INC_H()  //    0x24
+{
+	registers.h++;
+}
+void DEC_H()  //    0x25
+{
+	registers.h = dec(registers.h);
+}
+void LD_H_d8()  //    0x26
+{
+	registers.h = Operand8;
+}
+void DAA()  //    0x27
+{
+	{
+		unsigned short s = registers.a;
+
+		if (test_bit(6, registers.f)) {
+			if (test_bit(5, registers.f)) s = (s - 0x06) & 0xFF;
+			if (test_bit(4, registers.f)) s -= 0x60;
+		}
+		else {
+			if (test_bit(5, registers.f) || (s & 0xF) > 9) s += 0x06;
+			if (test_bit(4, registers.f) || s > 0x9F) s += 0x60;
+		}
+
+		registers.a = s;
+		Clear_H_Flag();
+
+		if (registers.a)
+			Clear_Z_Flag();
+		else
+			Set_Z_Flag();
+
+		if (s >= 0x100) Set_C_Flag();
+	}
+}
+void JR_Z_r8()  //    0x28
+{
+	if (registers.f & 0x80) {
+		registers.pc += (signed char)Operand8;
+	}
+}
+void ADD_HL_HL()  //    0x29
+{
+	registers.hl = add_2_byte(registers.hl, registers.hl);
+}
+void LD_A_HLIp()  //    0x2a
+{
+	registers.a = read_byte(registers.hl);
+	registers.hl++;
+}
+void DEC_HL()  //    0x2b
+{
+	registers.hl--;
+}
+void INC_L()  //    0x2c
+{
+	registers.l = inc(registers.l);
+}
+void DEC_L()  //    0x2d
+{
+	registers.l = dec(registers.l);
+}
+void LD_L_d8()  //    0x2e
+{
+	registers.l = Operand8;
+}
+void CPL()  //    0x2f
+{
+	registers.a = ~registers.a;
+	void CLear_N_Flag();
+	void Clear_H_Flag();
+}
+void JR_NC_r8()  //    0x30
+{
+	if ((registers.f & 0x10) == 0x00) {
+		registers.pc += (signed char)Operand8;
+	}
+}
+void LD_SP_d16()  //    0x31
+{
+	registers.sp = Operand16;
+}
+void LD_HLdp_A()  //    0x32
+{
+	write_byte(registers.a, registers.hl);
+	registers.hl--;
+}
+void INC_SP()  //    0x33
+{
+	registers.sp++;
+}
+void INC_HLp()  //    0x34
+{
+	write_byte(inc(read_byte(registers.hl)), registers.hl);
+}
+void DEC_HLp()  //    0x35
+{
+	write_byte(dec(read_byte(registers.hl)), registers.hl);
+}
+void LD_HLp_d8()  //    0x36
+{
+	write_byte(Operand8, registers.hl);
+}
+void SCF()  //    0x37
+{
+	Set_C_Flag();
+}
+void JR_C_r8()  //    0x38
+{
+	if (registers.f & 0x10) {
+		registers.pc += (signed char)Operand8;
+	}
+}
+void ADD_HL_SP()  //    0x39
+{
+	registers.hl = add_2_byte(registers.hl, registers.sp);
+}
+void LD_A_HLdp()  //    0x3a
+{
+	registers.a = read_byte(registers.hl);
+	registers.hl--;
+}
+void DEC_SP()  //    0x3b
+{
+	registers.sp--;
+}
+void INC_A()  //    0x3c
+{
+	registers.a = inc(registers.a);
+}
+void DEC_A()  //    0x3d
+{
+	registers.a = dec(registers.a);
+}
+void LD_A_d8()  //    0x3e
+{
+	registers.a = Operand8;
+}
+void CCF()  //    0x3f
+{
+	if (registers.f & 0x10) {
+		Clear_C_Flag();
+	}
+	else {
+		Set_C_Flag();
+	}
+}
+void LD_B_B()  //    0x40
+{
+	registers.b = registers.b;
+
+	// Mooneye's test roms end on this, with the result in the registers.
+	// Other roms run it as ordinary code, so only stop on a signature.
+	if (breakpoint_stop_enabled && (mooneye_passed() || mooneye_failed())) {
+		breakpoint_hit = true;
+		stop_core();
+	}
+}
+void LD_B_C()  //    0x41
+{
+	registers.b = registers.c;
+}
+void LD_B_D()  //    0x42
+{
+	registers.b = registers.d;
+}
+void LD_B_E()  //    0x43
+{
+	registers.b = registers.e;
+}
+void LD_B_H()  //    0x44
+{
+	registers.b = registers.h;
+}
+void LD_B_L()  //    0x45
+{
+	registers.b = registers.l;
+}
+void LD_B_HLp()  //    0x46
+{
+	registers.b = read_byte(registers.hl);
+}
+void LD_B_A()  //    0x47
+{
+	registers.b = registers.a;
+}
+void LD_C_B()  //    0x48
+{
+	registers.c = registers.b;
+}
+void LD_C_C()  //    0x49
+{
+	registers.c = registers.c;
+}
+void LD_C_D()  //    0x4a
+{
+	registers.c = registers.d;
+}
+void LD_C_E()  //    0x4b
+{
+	registers.c = registers.e;
+}
+void LD_C_H()  //    0x4c
+{
+	registers.c = registers.h;
+}
+void LD_C_L()  //    0x4d
+{
+	registers.c = registers.l;
+}
+void LD_C_HLp()  //    0x4e
+{
+	registers.c = read_byte(registers.hl);
+}
+void LD_C_A()  //    0x4f
+{
+	registers.c = registers.a;
+}
+void LD_D_B()  //    0x50
+{
+	registers.d = registers.b;
+}
+void LD_D_C()  //    0x51
+{
+	registers.d = registers.c;
+}
+void LD_D_D()  //    0x52
+{
+	registers.d = registers.d;
+}
+void LD_D_E()  //    0x53
+{
+	registers.d = registers.e;
+}
+void LD_D_H()  //    0x54
+{
+	registers.d = registers.h;
+}
+void LD_D_L()  //    0x55
+{
+	registers.d = registers.l;
+}
+void LD_D_HLp()  //    0x56
+{
+	registers.d = read_byte(registers.hl);
+}
+void LD_D_A()  //    0x57
+{
+	registers.d = registers.a;
+}
+void LD_E_B()  //    0x58
+{
+	registers.e = registers.b;
+}
+void LD_E_C()  //    0x59
+{
+	registers.e = registers.c;
+}
+void LD_E_D()  //    0x5a
+{
+	registers.e = registers.d;
+}
+void LD_E_E()  //    0x5b
+{
+	registers.e = registers.e;
+}
+void LD_E_H()  //    0x5c
+{
+	registers.e = registers.h;
+}
+void LD_E_L()  //    0x5d
+{
+	registers.e = registers.l;
+}
+void LD_E_HLp()  //    0x5e
+{
+	registers.e = read_byte(registers.hl);
+}
+void LD_E_A()  //    0x5f
+{
+	registers.e = registers.a;
+}
+void LD_H_B()  //    0x60
+{
+	registers.h = registers.b;
+}
+void LD_H_C()  //    0x61
+{
+	registers.h = registers.c;
+}
+void LD_H_D()  //    0x62
+{
+	registers.h = registers.d;
+}
+void LD_H_E()  //    0x63
+{
+	registers.h = registers.e;
+}
+void LD_H_H()  //    0x64
+{
+	registers.h = registers.h;
+}
+void LD_H_L()  //    0x65
+{
+	registers.h = registers.l;
+}
+void LD_H_HLp()  //    0x66
+{
+	registers.h = read_byte(registers.hl);
+}
+void LD_H_A()  //    0x67
+{
+	registers.h = registers.a;
+}
+void LD_L_B()  //    0x68
+{
+	registers.l = registers.b;
+}
+void LD_L_C()  //    0x69
+{
+	registers.l = registers.c;
+}
+void LD_L_D()  //    0x6a
+{
+	registers.l = registers.d;
+}
+void LD_L_E()  //    0x6b
+{
+	registers.l = registers.e;
+}
+void LD_L_H()  //    0x6c
+{
+	registers.l = registers.h;
+}
+void LD_L_L()  //    0x6d
+{
+	registers.l = registers.l;
+}
+void LD_L_HLp()  //    0x6e
+{
+	registers.l = read_byte(registers.hl);
+}
+void LD_L_A()  //    0x6f
+{
+	registers.l = registers.a;
+}
+void LD_HLp_B()  //    0x70
+{
+	write_byte(registers.b, registers.hl);
+}
+void LD_HLp_C()  //    0x71
+{
+	write_byte(registers.c, registers.hl);
+}
+void LD_HLp_D()  //    0x72
+{
+	write_byte(registers.d, registers.hl);
+}
+void LD_HLp_E()  //    0x73
+{
+	write_byte(registers.e, registers.hl);
+}
+void LD_HLp_H()  //    0x74
+{
+	write_byte(registers.h, registers.hl);
+}
+void LD_HLp_L()  //    0x75
+{
+	write_byte(registers.l, registers.hl);
+}
+void HALT()  //    0x76
+{
+	// printf("Unimplemented Instruction!! HALT\n");
+}
+void LD_HLp_A()  //    0x77
+{
+	write_byte(registers.a, registers.hl);
+}
+void LD_A_B()  //    0x78
+{
+	registers.a = registers.b;
+}
+void LD_A_C()  //    0x79
+{
+	registers.a = registers.c;
+}
+void LD_A_D()  //    0x7a
+{
+	registers.a = registers.d;
+}
+void LD_A_E()  //    0x7b
+{
+	registers.a = registers.e;
+}
+void LD_A_H()  //    0x7c
+{
+	registers.a = registers.h;
+}
+void LD_A_L()  //    0x7d
+{
+	registers.a = registers.l;
+}
+void LD_A_HLp()  //    0x7e
+{
+	registers.a = read_byte(registers.hl);
+}
+void LD_A_A()  //    0x7f
+{
+	registers.a = registers.a;
+}
+void ADD_A_B()  //    0x80
+{
+	add_byte(registers.b);
+}
+void ADD_A_C()  //    0x81
+{
+	add_byte(registers.c);
+}
+void ADD_A_D()  //    0x82
+{
+	add_byte(registers.d);
+}
+void ADD_A_E()  //    0x83
+{
+	add_byte(registers.e);
+}
+void ADD_A_H()  //    0x84
+{
+	add_byte(registers.h);
+}
+void ADD_A_L()  //    0x85
+{
+	add_byte(registers.l);
+}
+void ADD_A_HLp()  //    0x86
+{
+	add_byte(read_byte(registers.hl));
+}
+void ADD_A_A()  //    0x87
+{
+	add_byte(registers.a);
+}
+void ADC_A_B()  //    0x88
+{
+	adc(registers.b);
+}
+void ADC_A_C()  //    0x89
+{
+	adc(registers.c);
+}
+void ADC_A_D()  //    0x8a
+{
+	adc(registers.d);
+}
+void ADC_A_E()  //    0x8b
+{
+	adc(registers.e);
+}
+void ADC_A_H()  //    0x8c
+{
+	adc(registers.h);
+}
+void ADC_A_L()  //    0x8d
+{
+	adc(registers.l);
+}
+void ADC_A_HLp()  //    0x8e
+{
+	adc(read_byte(registers.hl));
+}
+void ADC_A_A()  //    0x8f
+{
+	adc(registers.a);
+}
+void SUB_B()  //    0x90
+{
+	sub_byte(registers.b);
+}
+void SUB_C()  //    0x91
+{
+	sub_byte(registers.c);
+}
+void SUB_D()  //    0x92
+{
+	sub_byte(registers.d);
+}
+void SUB_E()  //    0x93
+{
+	sub_byte(registers.e);
+}
+void SUB_H()  //    0x94
+{
+	sub_byte(registers.h);
+}
+void SUB_L()  //    0x95
+{
+	sub_byte(registers.l);
+}
+void SUB_HLp()  //    0x96
+{
+	sub_byte(read_byte(registers.hl));
+}
+void SUB_A()  //    0x97
+{
+	sub_byte(registers.a);
+}
+void SBC_A_B()  //    0x98
+{
+	Sbc(registers.b);
+}
+void SBC_A_C()  //    0x99
+{
+	Sbc(registers.c);
+}
+void SBC_A_D()  //    0x9a
+{
+	Sbc(registers.d);
+}
+void SBC_A_E()  //    0x9b
+{
+	Sbc(registers.e);
+}
+void SBC_A_H()  //    0x9c
+{
+	Sbc(registers.h);
+}
+void SBC_A_L()  //    0x9d
+{
+	Sbc(registers.l);
+}
+void SBC_A_HLp()  //    0x9e
+{
+	Sbc(read_byte(registers.hl));
+}
+void SBC_A_A()  //    0x9f
+{
+	Sbc(registers.a);
+}
+void AND_B()  //    0xa0
+{
+	And(registers.b);
+}
+void AND_C()  //    0xa1
+{
+	And(registers.c);
+}
+void AND_D()  //    0xa2
+{
+	And(registers.d);
+}
+void AND_E()  //    0xa3
+{
+	And(registers.e);
+}
+void AND_H()  //    0xa4
+{
+	And(registers.h);
+}
+void AND_L()  //    0xa5
+{
+	And(registers.l);
+}
+void AND_HLp()  //    0xa6
+{
+	And(read_byte(registers.hl));
+}
+void AND_A()  //    0xa7
+{
+	And(registers.a);
+}
+void XOR_B()  //    0xa8
+{
+	Xor(registers.b);
+}
+void XOR_C()  //    0xa9
+{
+	Xor(registers.c);
+}
+void XOR_D()  //    0xaa
+{
+	Xor(registers.d);
+}
+void XOR_E()  //    0xab
+{
+	Xor(registers.e);
+}
+void XOR_H()  //    0xac
+{
+	Xor(registers.h);
+}
+void XOR_L()  //    0xad
+{
+	Xor(registers.l);
+}
+void XOR_HLp()  //    0xae
+{
+	Xor(read_byte(registers.hl));
+}
+void XOR_A()  //    0xaf
+{
+	Xor(registers.a);
+}
+void OR_B()  //    0xb0
+{
+	Or(registers.b);
+}
+void OR_C()  //    0xb1
+{
+	Or(registers.c);
+}
+void OR_D()  //    0xb2
+{
+	Or(registers.d);
+}
+void OR_E()  //    0xb3
+{
+	Or(registers.e);
+}
+void OR_H()  //    0xb4
+{
+	Or(registers.h);
+}
+void OR_L()  //    0xb5
+{
+	Or(registers.l);
+}
+void OR_HLp()  //    0xb6
+{
+	Or(read_byte(registers.hl));
+}
+void OR_A()  //    0xb7
+{
+	Or(registers.a);
+}
+void CP_B()  //    0xb8
+{
+	cp(registers.b);
+}
+void CP_C()  //    0xb9
+{
+	cp(registers.c);
+}
+void CP_D()  //    0xba
+{
+	cp(registers.d);
+}
+void CP_E()  //    0xbb
+{
+	cp(registers.e);
+}
+void CP_H()  //    0xbc
+{
+	cp(registers.h);
+}
+void CP_L()  //    0xbd
+{
+	cp(registers.l);
+}
+void CP_HLp()  //    0xbe
+{
+	cp(read_byte(registers.hl));
+}
+void CP_A()  //    0xbf
+{
+	cp(registers.a);
+}
+void RET_NZ()  //    0xc0
+{
+	if ((registers.f & 0x80) == 0x00) {
+		Return();
+	}
+}
+void POP_BC()  //    0xc1
+{
+	registers.bc = Pop();
+}
+void JP_NZ_a16()  //    0xc2
+{
+	if ((registers.f & 0x80) == 0x00) {
+		registers.pc = Operand16;
+	}
+}
+void JP_a16()  //    0xc3
+{
+	registers.pc = Operand16;
+}
+void CALL_NZ_a16()  //    0xc4
+{
+	if ((registers.f & 0x80) == 0x00) {
+		Call(Operand16);
+	}
+}
+void PUSH_BC()  //    0xc5
+{
+	Push(registers.bc);
+}
+void ADD_A_d8()  //    0xc6
+{
+	add_byte(Operand8);
+}
+void RST_00H()  //    0xc7
+{
+	Call(0x0000);
+}
+void RET_Z()  //    0xc8
+{
+	if (registers.f & 0x80) {
+		Return();
+	}
+}
+void RET()  //    0xc9
+{
+	Return();
+}
+void JP_Z_a16()  //    0xca
+{
+	if (registers.f & 0x80) {
+		registers.pc = Operand16;
+	}
+}
+void PREFIX_CB()  //    0xcb
+{
+	printf("Unimplemented Instruction!!, CB\n");
+}
+void CALL_Z_a16()  //    0xcc
+{
+	if (registers.f & 0x80) {
+		Call(Operand16);
+	}
+}
+void CALL_a16()  //    0xcd
+{
+	Call(Operand16);
+}
+void ADC_A_d8()  //    0xce
+{
+	adc(Operand8);
+}
+void RST_08H()  //    0xcf
+{
+	Call(0x0008);
+}
+void RET_NC()  //    0xd0
+{
+	if ((registers.f & 0x10) == 0x00) {
+		Return();
+	}
+}
+void POP_DE()  //    0xd1
+{
+	registers.de = Pop();
+}
+void JP_NC_a16()  //    0xd2
+{
+	if ((registers.f & 0x10) == 0x00) {
+		registers.pc = Operand16;
+	}
+}
+void CALL_NC_a16()  //    0xd4
+{
+	if ((registers.f & 0x10) == 0x00) {
+		Push(Operand16);
+		registers.pc = Operand16;
+	}
+}
+void PUSH_DE()  //    0xd5
+{
+	Push(registers.de);
+}
+void SUB_d8()  //    0xd6
+{
+	sub_byte(Operand8);
+}
+void RST_10H()  //    0xd7
+{
+	Call(0x0010);
+}
+void RET_C()  //    0xd8
+{
+	if (registers.f & 0x10) {
+		Return();
+	}
+}
+void RETI()  //    0xd9
+{
+	Return();
+	IME = 1;  // Enable master interupt flag.
+}
+void JP_C_a16()  //    0xda
+{
+	if (registers.f & 0x10) {
+		registers.pc = Operand16;
+	}
+}
+void CALL_C_a16()  //    0xdc
+{
+	if (registers.f & 0x10) {
+		Push(Operand16);
+		registers.pc = Operand16;
+	}
+}
+void SBC_A_d8()  //    0xde
+{
+	Sbc(Operand8);
+}
+void RST_18H()  //    0xdf
+{
+	Call(0x0018);
+}
+void LDH_a8p_A()  //    0xe0
+{
+	write_byte(registers.a, 0xFF00 + Operand8);
+}
+void POP_HL()  //    0xe1
+{
+	registers.hl = Pop();
+}
+void LD_Cp_A()  //    0xe2
+{
+	write_byte(registers.a, 0xFF00 + registers.c);
+}
+void PUSH_HL()  //    0xe5
+{
+	Push(registers.hl);
+}
+void AND_d8()  //    0xe6
+{
+	And(Operand8);
+}
+void RST_20H()  //    0xe7
+{
+	Call(0x0020);
+}
+void ADD_SP_r8()  //    0xe8
+{
+	registers.sp = add_2_byte(registers.sp, (uint16_t)Operand8);
+}
+void JP_HLp()  //    0xe9
+{
+	registers.pc = registers.hl;
+}
+void LD_a16p_A()  //    0xea
+{
+	write_byte(registers.a, Operand16);
+}
+void XOR_d8()  //    0xee
+{
+	Xor(Operand8);
+}
+void RST_28H()  //    0xef
+{
+	Call(0x0028);
+}
+void LDH_A_a8p()  //    0xf0
+{
+	registers.a = read_byte(0xFF00 + Operand8);
+}
+void POP_AF()  //    0xf1
+{
+	registers.af = Pop();
+}
+void LD_A_Cp()  //    0xf2
+{
+	registers.a = read_byte(0xFF00 + registers.c);
+}
+void DI()  //    0xf3
+{
+	IME = 0;
+}
+void PUSH_AF()  //    0xf5
+{
+	Push(registers.af);
+}
+void OR_d8()  //    0xf6
+{
+	Or(Operand8);
+}
+void RST_30H()  //    0xf7
+{
+	Call(0x0030);
+}
+void LD_HL_SPr8()  //    0xf8
+{
+	registers.hl = registers.sp + Operand8;  // Needs work.
+}
+void LD_SP_HL()  //    0xf9
+{
+	registers.sp = registers.hl;
+}
+void LD_A_a16p()  //    0xfa
+{
+	registers.a = read_byte(Operand16);
+}
+void EI()  //    0xfb
+{
+	IME = 1;
+}
+void CP_d8()  //    0xfe
+{
+	cp(Operand8);
+}
+void RST_38H()  //    0xff
+{
+	Call(0x0038);
+}
+
+// Declarations for Cb prefixed instructions.
+
+void RLC_B()  //    0x0
+{
+	registers.b = RotByteLeft(registers.b);
+}
+void RLC_C()  //    0x1
+{
+	registers.c = RotByteLeft(registers.c);
+}
+void RLC_D()  //    0x2
+{
+	registers.d = RotByteLeft(registers.d);
+}
+void RLC_E()  //    0x3
+{
+	registers.e = RotByteLeft(registers.e);
+}
+void RLC_H()  //    0x4
+{
+	registers.h = RotByteLeft(registers.h);
+}
+void RLC_L()  //    0x5
+{
+	registers.l = RotByteLeft(registers.l);
+}
+void RLC_HLp()  //    0x6
+{
+	write_byte(RotByteLeft(read_byte(registers.hl)), registers.hl);
+}
+void RLC_A()  //    0x7
+{
+	registers.a = RotByteLeft(registers.a);
+}
+void RRC_B()  //    0x8
+{
+	registers.b = RotByteRight(registers.b);
+}
+void RRC_C()  //    0x9
+{
+	registers.c = RotByteRight(registers.c);
+}
+void RRC_D()  //    0xa
+{
+	registers.d = RotByteRight(registers.d);
+}
+void RRC_E()  //    0xb
+{
+	registers.e = RotByteRight(registers.e);
+}
+void RRC_H()  //    0xc
+{
+	registers.h = RotByteRight(registers.h);
+}
+void RRC_L()  //    0xd
+{
+	registers.l = RotByteRight(registers.l);
+}
+void RRC_HLp()  //    0xe
+{
+	write_byte(RotByteRight(read_byte(registers.hl)), registers.hl);
+}
+void RRC_A()  //    0xf
+{
+	registers.a = RotByteRight(registers.a);
+}
+void RL_B()  //    0x10
+{
+	registers.b = Rotate_Left_Carry(registers.b);
+}
+void RL_C()  //    0x11
+{
+	registers.c = Rotate_Left_Carry(registers.c);
+}
+void RL_D()  //    0x12
+{
+	registers.d = Rotate_Left_Carry(registers.d);
+}
+void RL_E()  //    0x13
+{
+	registers.e = Rotate_Left_Carry(registers.e);
+}
+void RL_H()  //    0x14
+{
+	registers.h = Rotate_Left_Carry(registers.h);
+}
+void RL_L()  //    0x15
+{
+	registers.l = Rotate_Left_Carry(registers.l);
+}
+void RL_HLp()  //    0x16
+{
+	write_byte(Rotate_Left_Carry(read_byte(registers.hl)), registers.hl);
+}
+void RL_A()  //    0x17
+{
+	registers.a = Rotate_Left_Carry(registers.a);
+}
+void RR_B()  //    0x18
+{
+	registers.b = Rotate_Right_Carry(registers.b);
+}
+void RR_C()  //    0x19
+{
+	registers.c = Rotate_Right_Carry(registers.c);
+}
+void RR_D()  //    0x1a
+{
+	registers.d = Rotate_Right_Carry(registers.d);
+}
+void RR_E()  //    0x1b
+{
+	registers.e = Rotate_Right_Carry(registers.e);
+}
+void RR_H()  //    0x1c
+{
+	registers.h = Rotate_Right_Carry(registers.h);
+}
+void RR_L()  //    0x1d
+{
+	registers.l = Rotate_Right_Carry(registers.l);
+}
+void RR_HLp()  //    0x1e
+{
+	write_byte(Rotate_Right_Carry(read_byte(registers.hl)), registers.hl);
+}
+void RR_A()  //    0x1f
+{
+	registers.a = Rotate_Right_Carry(registers.a);
+}
+void SLA_B()  //    0x20
+{
+	registers.b = Shift_Left(registers.b);
+}
+void SLA_C()  //    0x21
+{
+	registers.c = Shift_Left(registers.c);
+}
+void SLA_D()  //    0x22
+{
+	registers.d = Shift_Left(registers.d);
+}
+void SLA_E()  //    0x23
+{
+	registers.e = Shift_Left(registers.e);
+}
+void SLA_H()  //    0x24
+{
+	registers.h = Shift_Left(registers.h);
+}
+void SLA_L()  //    0x25
+{
+	registers.l = Shift_Left(registers.l);
+}
+void SLA_HLp()  //    0x26
+{
+	write_byte(Shift_Left(read_byte(registers.hl)), registers.hl);
+}
+void SLA_A()  //    0x27
+{
+	registers.a = Shift_Left(registers.a);
+}
+void SRA_B()  //    0x28
+{
+	registers.b = Shift_Right_A(registers.b);
+}
+void SRA_C()  //    0x29
+{
+	registers.c = Shift_Right_A(registers.c);
+}
+void SRA_D()  //    0x2a
+{
+	registers.d = Shift_Right_A(registers.d);
+}
+void SRA_E()  //    0x2b
+{
+	registers.e = Shift_Right_A(registers.e);
+}
+void SRA_H()  //    0x2c
+{
+	registers.h = Shift_Right_A(registers.h);
+}
+void SRA_L()  //    0x2d
+{
+	registers.l = Shift_Right_A(registers.l);
+}
+void SRA_HLp()  //    0x2e
+{
+	write_byte(Shift_Right_A(read_byte(registers.hl)), registers.hl);
+}
+void SRA_A()  //    0x2f
+{
+	registers.a = Shift_Right_A(registers.a);
+}
+void SWAP_B()  //    0x30
+{
+	registers.b = Swap(registers.b);
+}
+void SWAP_C()  //    0x31
+{
+	registers.c = Swap(registers.c);
+}
+void SWAP_D()  //    0x32
+{
+	registers.d = Swap(registers.d);
+}
+void SWAP_E()  //    0x33
+{
+	registers.e = Swap(registers.e);
+}
+void SWAP_H()  //    0x34
+{
+	registers.h = Swap(registers.h);
+}
+void SWAP_L()  //    0x35
+{
+	registers.l = Swap(registers.l);
+}
+void SWAP_HLp()  //    0x36
+{
+	write_byte(Swap(read_byte(registers.hl)), registers.hl);
+}
+void SWAP_A()  //    0x37
+{
+	registers.a = Swap(registers.a);
+}
+void SRL_B()  //    0x38
+{
+	registers.b = Shift_Right(registers.b);
+}
+void SRL_C()  //    0x39
+{
+	registers.c = Shift_Right(registers.c);
+}
+void SRL_D()  //    0x3a
+{
+	registers.d = Shift_Right(registers.d);
+}
+void SRL_E()  //    0x3b
+{
+	registers.e = Shift_Right(registers.e);
+}
+void SRL_H()  //    0x3c
+{
+	registers.h = Shift_Right(registers.h);
+}
+void SRL_L()  //    0x3d
+{
+	registers.l = Shift_Right(registers.l);
+}
+void SRL_HLp()  //    0x3e
+{
+	write_byte(Shift_Right(read_byte(registers.hl)), registers.hl);
+}
+void SRL_A()  //    0x3f
+{
+	registers.a = Shift_Right(registers.a);
+}
+void BIT_0_B()  //    0x40
+{
+	Bit_Test(0, registers.b);
+}
+void BIT_0_C()  //    0x41
+{
+	Bit_Test(0, registers.c);
+}
+void BIT_0_D()  //    0x42
+{
+	Bit_Test(0, registers.d);
+}
+void BIT_0_E()  //    0x43
+{
+	Bit_Test(0, registers.e);
+}
+void BIT_0_H()  //    0x44
+{
+	Bit_Test(0, registers.h);
+}
+void BIT_0_L()  //    0x45
+{
+	Bit_Test(0, registers.l);
+}
+void BIT_0_HLp()  //    0x46
+{
+	Bit_Test(0, read_byte(registers.hl));
+}
+void BIT_0_A()  //    0x47
+{
+	Bit_Test(0, registers.a);
+}
+void BIT_1_B()  //    0x48
+{
+	Bit_Test(1, registers.b);
+}
+void BIT_1_C()  //    0x49
+{
+	Bit_Test(1, registers.b);
+}
+void BIT_1_D()  //    0x4a
+{
+	Bit_Test(1, registers.d);
+}
+void BIT_1_E()  //    0x4b
+{
+	Bit_Test(1, registers.e);
+}
+void BIT_1_H()  //    0x4c
+{
+	Bit_Test(1, registers.h);
+}
+void BIT_1_L()  //    0x4d
+{
+	Bit_Test(1, registers.l);
+}
+void BIT_1_HLp()  //    0x4e
+{
+	Bit_Test(1, read_byte(registers.hl));
+}
+void BIT_1_A()  //    0x4f
+{
+	Bit_Test(1, registers.a);
+}
+void BIT_2_B()  //    0x50
+{
+	Bit_Test(2, registers.b);
+}
+void BIT_2_C()  //    0x51
+{
+	Bit_Test(2, registers.c);
+}
+void BIT_2_D()  //    0x52
+{
+	Bit_Test(2, registers.d);
+}
+void BIT_2_E()  //    0x53
+{
+	Bit_Test(2, registers.e);
+}
+void BIT_2_H()  //    0x54
+{
+	Bit_Test(2, registers.h);
+}
+void BIT_2_L()  //    0x55
+{
+	Bit_Test(2, registers.l);
+}
+void BIT_2_HLp()  //    0x56
+{
+	Bit_Test(2, read_byte(registers.hl));
+}
+void BIT_2_A()  //    0x57
+{
+	Bit_Test(2, registers.a);
+}
+void BIT_3_B()  //    0x58
+{
+	Bit_Test(3, registers.b);
+}
+void BIT_3_C()  //    0x59
+{
+	Bit_Test(3, registers.c);
+}
+void BIT_3_D()  //    0x5a
+{
+	Bit_Test(3, registers.d);
+}
+void BIT_3_E()  //    0x5b
+{
+	Bit_Test(3, registers.e);
+}
+void BIT_3_H()  //    0x5c
+{
+	Bit_Test(3, registers.h);
+}
+void BIT_3_L()  //    0x5d
+{
+	Bit_Test(3, registers.l);
+}
+void BIT_3_HLp()  //    0x5e
+{
+	Bit_Test(3, read_byte(registers.hl));
+}
+void BIT_3_A()  //    0x5f
+{
+	Bit_Test(3, registers.a);
+}
+void BIT_4_B()  //    0x60
+{
+	Bit_Test(4, registers.b);
+}
+void BIT_4_C()  //    0x61
+{
+	Bit_Test(4, registers.c);
+}
+void BIT_4_D()  //    0x62
+{
+	Bit_Test(4, registers.d);
+}
+void BIT_4_E()  //    0x63
+{
+	Bit_Test(4, registers.e);
+}
+void BIT_4_H()  //    0x64
+{
+	Bit_Test(4, registers.h);
+}
+void BIT_4_L()  //    0x65
+{
+	Bit_Test(4, registers.l);
+}
+void BIT_4_HLp()  //    0x66
+{
+	Bit_Test(4, read_byte(registers.hl));
+}
+void BIT_4_A()  //    0x67
+{
+	Bit_Test(4, registers.a);
+}
+void BIT_5_B()  //    0x68
+{
+	Bit_Test(5, registers.b);
+}
+void BIT_5_C()  //    0x69
+{
+	Bit_Test(5, registers.c);
+}
+void BIT_5_D()  //    0x6a
+{
+	Bit_Test(5, registers.d);
+}
+void BIT_5_E()  //    0x6b
+{
+	Bit_Test(5, registers.e);
+}
+void BIT_5_H()  //    0x6c
+{
+	Bit_Test(5, registers.h);
+}
+void BIT_5_L()  //    0x6d
+{
+	Bit_Test(5, registers.l);
+}
+void BIT_5_HLp()  //    0x6e
+{
+	Bit_Test(5, read_byte(registers.hl));
+}
+void BIT_5_A()  //    0x6f
+{
+	Bit_Test(5, registers.a);
+}
+void BIT_6_B()  //    0x70
+{
+	Bit_Test(6, registers.b);
+}
+void BIT_6_C()  //    0x71
+{
+	Bit_Test(6, registers.c);
+}
+void BIT_6_D()  //    0x72
+{
+	Bit_Test(6, registers.d);
+}
+void BIT_6_E()  //    0x73
+{
+	Bit_Test(6, registers.e);
+}
+void BIT_6_H()  //    0x74
+{
+	Bit_Test(6, registers.h);
+}
+void BIT_6_L()  //    0x75
+{
+	Bit_Test(6, registers.l);
+}
+void BIT_6_HLp()  //    0x76
+{
+	Bit_Test(6, read_byte(registers.hl));
+}
+void BIT_6_A()  //    0x77
+{
+	Bit_Test(6, registers.a);
+}
+void BIT_7_B()  //    0x78
+{
+	Bit_Test(7, registers.b);
+}
+void BIT_7_C()  //    0x79
+{
+	Bit_Test(7, registers.c);
+}
+void BIT_7_D()  //    0x7a
+{
+	Bit_Test(7, registers.d);
+}
+void BIT_7_E()  //    0x7b
+{
+	Bit_Test(7, registers.e);
+}
+void BIT_7_H()  //    0x7c
+{
+	Bit_Test(7, registers.h);
+}
+void BIT_7_L()  //    0x7d
+{
+	Bit_Test(7, registers.l);
+}
+void BIT_7_HLp()  //    0x7e
+{
+	Bit_Test(7, read_byte(registers.hl));
+}
+void BIT_7_A()  //    0x7f
+{
+	Bit_Test(7, registers.a);
+}
+void RES_0_B()  //    0x80
+{
+	registers.b = Res(0, registers.b);
+}
+void RES_0_C()  //    0x81
+{
+	registers.c = Res(0, registers.c);
+}
+void RES_0_D()  //    0x82
+{
+	registers.d = Res(0, registers.d);
+}
+void RES_0_E()  //    0x83
+{
+	registers.e = Res(0, registers.e);
+}
+void RES_0_H()  //    0x84
+{
+	registers.h = Res(0, registers.h);
+}
+void RES_0_L()  //    0x85
+{
+	registers.l = Res(0, registers.l);
+}
+void RES_0_HLp()  //    0x86
+{
+	write_byte(Res(0, read_byte(registers.hl)), registers.hl);
+}
+void RES_0_A()  //    0x87
+{
+	registers.a = Res(0, registers.a);
+}
+void RES_1_B()  //    0x88
+{
+	registers.b = Res(1, registers.b);
+}
+void RES_1_C()  //    0x89
+{
+	registers.c = Res(1, registers.c);
+}
+void RES_1_D()  //    0x8a
+{
+	registers.d = Res(1, registers.d);
+}
+void RES_1_E()  //    0x8b
+{
+	registers.e = Res(1, registers.e);
+}
+void RES_1_H()  //    0x8c
+{
+	registers.h = Res(1, registers.h);
+}
+void RES_1_L()  //    0x8d
+{
+	registers.l = Res(1, registers.l);
+}
+void RES_1_HLp()  //    0x8e
+{
+	write_byte(Res(1, read_byte(registers.hl)), registers.hl);
+}
+void RES_1_A()  //    0x8f
+{
+	registers.a = Res(1, registers.a);
+}
+void RES_2_B()  //    0x90
+{
+	registers.b = Res(2, registers.b);
+}
+void RES_2_C()  //    0x91
+{
+	registers.c = Res(2, registers.c);
+}
+void RES_2_D()  //    0x92
+{
+	registers.d = Res(2, registers.d);
+}
+void RES_2_E()  //    0x93
+{
+	registers.e = Res(2, registers.e);
+}
+void RES_2_H()  //    0x94
+{
+	registers.h = Res(2, registers.h);
+}
+void RES_2_L()  //    0x95
+{
+	registers.l = Res(2, registers.l);
+}
+void RES_2_HLp()  //    0x96
+{
+	write_byte(Res(2, read_byte(registers.hl)), registers.hl);
+}
+void RES_2_A()  //    0x97
+{
+	registers.a = Res(2, registers.a);
+}
+void RES_3_B()  //    0x98
+{
+	registers.b = Res(3, registers.b);
+}
+void RES_3_C()  //    0x99
+{
+	registers.c = Res(3, registers.c);
+}
+void RES_3_D()  //    0x9a
+{
+	registers.d = Res(3, registers.d);
+}
+void RES_3_E()  //    0x9b
+{
+	registers.e = Res(3, registers.e);
+}
+void RES_3_H()  //    0x9c
+{
+	registers.h = Res(3, registers.h);
+}
+void RES_3_L()  //    0x9d
+{
+	registers.l = Res(3, registers.l);
+}
+void RES_3_HLp()  //    0x9e
+{
+	write_byte(Res(3, read_byte(registers.hl)), registers.hl);
+}
+void RES_3_A()  //    0x9f
+{
+	registers.a = Res(3, registers.a);
+}
+void RES_4_B()  //    0xa0
+{
+	registers.b = Res(4, registers.b);
+}
+void RES_4_C()  //    0xa1
+{
+	registers.c = Res(4, registers.c);
+}
+void RES_4_D()  //    0xa2
+{
+	registers.d = Res(4, registers.d);
+}
+void RES_4_E()  //    0xa3
+{
+	registers.e = Res(4, registers.e);
+}
+void RES_4_H()  //    0xa4
+{
+	registers.h = Res(4, registers.h);
+}
+void RES_4_L()  //    0xa5
+{
+	registers.l = Res(4, registers.l);
+}
+void RES_4_HLp()  //    0xa6
+{
+	write_byte(Res(4, read_byte(registers.hl)), registers.hl);
+}
+void RES_4_A()  //    0xa7
+{
+	registers.a = Res(4, registers.a);
+}
+void RES_5_B()  //    0xa8
+{
+	registers.b = Res(5, registers.b);
+}
+void RES_5_C()  //    0xa9
+{
+	registers.c = Res(5, registers.c);
+}
+void RES_5_D()  //    0xaa
+{
+	registers.d = Res(5, registers.d);
+}
+void RES_5_E()  //    0xab
+{
+	registers.e = Res(5, registers.e);
+}
+void RES_5_H()  //    0xac
+{
+	registers.h = Res(5, registers.h);
+}
+void RES_5_L()  //    0xad
+{
+	registers.l = Res(5, registers.l);
+}
+void RES_5_HLp()  //    0xae
+{
+	write_byte(Res(5, read_byte(registers.hl)), registers.hl);
+}
+void RES_5_A()  //    0xaf
+{
+	registers.a = Res(5, registers.a);
+}
+void RES_6_B()  //    0xb0
+{
+	registers.b = Res(6, registers.b);
+}
+void RES_6_C()  //    0xb1
+{
+	registers.c = Res(6, registers.c);
+}
+void RES_6_D()  //    0xb2
+{
+	registers.d = Res(6, registers.d);
+}
+void RES_6_E()  //    0xb3
+{
+	registers.e = Res(6, registers.e);
+}
+void RES_6_H()  //    0xb4
+{
+	registers.h = Res(6, registers.h);
+}
+void RES_6_L()  //    0xb5
+{
+	registers.l = Res(6, registers.l);
+}
+void RES_6_HLp()  //    0xb6
+{
+	write_byte(Res(6, read_byte(registers.hl)), registers.hl);
+}
+void RES_6_A()  //    0xb7
+{
+	registers.a = Res(6, registers.a);
+}
+void RES_7_B()  //    0xb8
+{
+	registers.b = Res(7, registers.b);
+}
+void RES_7_C()  //    0xb9
+{
+	registers.c = Res(7, registers.c);
+}
+void RES_7_D()  //    0xba
+{
+	registers.d = Res(7, registers.d);
+}
+void RES_7_E()  //    0xbb
+{
+	registers.e = Res(7, registers.e);
+}
+void RES_7_H()  //    0xbc
+{
+	registers.h = Res(7, registers.h);
+}
+void RES_7_L()  //    0xbd
+{
+	registers.l = Res(7, registers.l);
+}
+void RES_7_HLp()  //    0xbe
+{
+	write_byte(Res(7, read_byte(registers.hl)), registers.hl);
+}
+void RES_7_A()  //    0xbf
+{
+	registers.a = Res(7, registers.a);
+}
+void SET_0_B()  //    0xc0
+{
+	registers.b = Set(0, registers.b);
+}
+void SET_0_C()  //    0xc1
+{
+	registers.c = Set(0, registers.c);
+}
+void SET_0_D()  //    0xc2
+{
+	registers.d = Set(0, registers.d);
+}
+void SET_0_E()  //    0xc3
+{
+	registers.e = Set(0, registers.e);
+}
+void SET_0_H()  //    0xc4
+{
+	registers.h = Set(0, registers.h);
+}
+void SET_0_L()  //    0xc5
+{
+	registers.l = Set(0, registers.l);
+}
+void SET_0_HLp()  //    0xc6
+{
+	write_byte(Set(0, read_byte(registers.hl)), registers.hl);
+}
+void SET_0_A()  //    0xc7
+{
+	registers.a = Set(0, registers.a);
+}
+void SET_1_B()  //    0xc8
+{
+	registers.b = Set(1, registers.b);
+}
+void SET_1_C()  //    0xc9
+{
+	registers.c = Set(1, registers.c);
+}
+void SET_1_D()  //    0xca
+{
+	registers.d = Set(1, registers.d);
+}
+void SET_1_E()  //    0xcb
+{
+	registers.e = Set(1, registers.e);
+}
+void SET_1_H()  //    0xcc
+{
+	registers.h = Set(1, registers.h);
+}
+void SET_1_L()  //    0xcd
+{
+	registers.l = Set(1, registers.l);
+}
+void SET_1_HLp()  //    0xce
+{
+	write_byte(Set(1, read_byte(registers.hl)), registers.hl);
+}
+void SET_1_A()  //    0xcf
+{
+	registers.a = Set(1, registers.a);
+}
+void SET_2_B()  //    0xd0
+{
+	registers.b = Set(2, registers.b);
+}
+void SET_2_C()  //    0xd1
+{
+	registers.c = Set(2, registers.c);
+}
+void SET_2_D()  //    0xd2
+{
+	registers.d = Set(2, registers.d);
+}
+void SET_2_E()  //    0xd3
+{
+	registers.e = Set(2, registers.e);
+}
+void SET_2_H()  //    0xd4
+{
+	registers.h = Set(2, registers.h);
+}
+void SET_2_L()  //    0xd5
+{
+	registers.l = Set(2, registers.l);
+}
+void SET_2_HLp()  //    0xd6
+{
+	write_byte(Set(2, read_byte(registers.hl)), registers.hl);
+}
+void SET_2_A()  //    0xd7
+{
+	registers.a = Set(2, registers.a);
+}
+void SET_3_B()  //    0xd8
+{
+	registers.b = Set(3, registers.b);
+}
+void SET_3_C()  //    0xd9
+{
+	registers.c = Set(3, registers.c);
+}
+void SET_3_D()  //    0xda
+{
+	registers.d = Set(3, registers.d);
+}
+void SET_3_E()  //    0xdb
+{
+	registers.e = Set(3, registers.e);
+}
+void SET_3_H()  //    0xdc
+{
+	registers.h = Set(3, registers.h);
+}
+void SET_3_L()  //    0xdd
+{
+	registers.l = Set(3, registers.l);
+}
+void SET_3_HLp()  //    0xde
+{
+	write_byte(Set(3, read_byte(registers.hl)), registers.hl);
+}
+void SET_3_A()  //    0xdf
+{
+	registers.a = Set(3, registers.a);
+}
+void SET_4_B()  //    0xe0
+{
+	registers.b = Set(4, registers.b);
+}
+void SET_4_C()  //    0xe1
+{
+	registers.c = Set(4, registers.c);
+}
+void SET_4_D()  //    0xe2
+{
+	registers.d = Set(4, registers.d);
+}
+void SET_4_E()  //    0xe3
+{
+	registers.e = Set(4, registers.e);
+}
+void SET_4_H()  //    0xe4
+{
+	registers.h = Set(4, registers.h);
+}
+void SET_4_L()  //    0xe5
+{
+	registers.l = Set(4, registers.l);
+}
+void SET_4_HLp()  //    0xe6
+{
+	write_byte(Set(4, read_byte(registers.hl)), registers.hl);
+}
+void SET_4_A()  //    0xe7
+{
+	registers.a = Set(4, registers.a);
+}
+void SET_5_B()  //    0xe8
+{
+	registers.b = Set(5, registers.b);
+}
+void SET_5_C()  //    0xe9
+{
+	registers.c = Set(5, registers.c);
+}
+void SET_5_D()  //    0xea
+{
+	registers.d = Set(5, registers.d);
+}
+void SET_5_E()  //    0xeb
+{
+	registers.e = Set(5, registers.e);
+}
+void SET_5_H()  //    0xec
+{
+	registers.h = Set(5, registers.h);
+}
+void SET_5_L()  //    0xed
+{
+	registers.l = Set(5, registers.l);
+}
+void SET_5_HLp()  //    0xee
+{
+	write_byte(Set(5, read_byte(registers.hl)), registers.hl);
+}
+void SET_5_A()  //    0xef
+{
+	registers.a = Set(5, registers.a);
+}
+void SET_6_B()  //    0xf0
+{
+	registers.b = Set(6, registers.b);
+}
+void SET_6_C()  //    0xf1
+{
+	registers.c = Set(6, registers.c);
+}
+void SET_6_D()  //    0xf2
+{
+	registers.d = Set(6, registers.d);
+}
+void SET_6_E()  //    0xf3
+{
+	registers.e = Set(6, registers.e);
+}
+void SET_6_H()  //    0xf4
+{
+	registers.h = Set(6, registers.h);
+}
+void SET_6_L()  //    0xf5
+{
+	registers.l = Set(6, registers.l);
+}
+void SET_6_HLp()  //    0xf6
+{
+	write_byte(Set(6, read_byte(registers.hl)), registers.hl);
+}
+void SET_6_A()  //    0xf7
+{
+	registers.a = Set(6, registers.a);
+}
+void SET_7_B()  //    0xf8
+{
+	registers.b = Set(7, registers.b);
+}
+void SET_7_C()  //    0xf9
+{
+	registers.c = Set(7, registers.c);
+}
+void SET_7_D()  //    0xfa
+{
+	registers.d = Set(7, registers.d);
+}
+void SET_7_E()  //    0xfb
+{
+	registers.e = Set(7, registers.e);
+}
+void SET_7_H()  //    0xfc
+{
+	registers.h = Set(7, registers.h);
+}
+void SET_7_L()  //    0xfd
+{
+	registers.l = Set(7, registers.l);
+}
+void SET_7_HLp()  //    0xfe
+{
+	write_byte(Set(7, read_byte(registers.hl)), registers.hl);
+}
+void SET_7_A()  //    0xff
+{
+	registers.a = Set(7, registers.a);
+}
@@ -0,0 +1,131 @@
+// Interface between the emulation core (gameboy.cpp) and the SDL front end.
+// The core runs on its own thread. Finished frames come out through
+// frame_mailbox, samples through audio_queue and key presses go in through
+// input_queue.
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
+#include "mailbox.h"
+#include "opcode_names.h"
+#include "spsc_queue.h"
+
+// Screen Dimensions.
+const int SCREEN_WIDTH = 160;
+const int SCREEN_HEIGHT = 144;
+
+// Clockspeed.
+#define CLOCKSPEED 4194304
+#define CYCLES_PER_FRAME 69905
+
+// A finished frame. Pixels are ARGB8888 host pixels, and every line has an
+// xxHash64 of its pixels so the front end can tell which lines changed.
+struct frame {
+	uint32_t pixels[SCREEN_HEIGHT][SCREEN_WIDTH];
+	uint64_t line_hash[SCREEN_HEIGHT];
+	uint64_t hash;  // xxHash64 of line_hash, so of the whole frame.
+	uint64_t time;  // Emulated cycle of the VBLANK that finished it.
+};
+
+// Number of selectable colour schemes (grey, DMG green, pocket).
+const int COLOR_SCHEMES = 3;
+
+// Audio output rate and one stereo sample of it.
+const int AUDIO_SAMPLE_RATE = 48000;
+struct audio_sample {
+	int16_t left;
+	int16_t right;
+};
+
+// Joypad bit number and whether it went down or up.
+struct input_event {
+	int key;
+	bool pressed;
+};
+
+extern FrameMailbox<frame> frame_mailbox;          // Written at VBLANK, read by the front end.
+extern SpscQueue<input_event, 64> input_queue;     // Written by the front end, read before each frame.
+extern SpscQueue<audio_sample, 4096> audio_queue;  // Written at the end of each frame, read by the front end's audio callback.
+extern bool audio_output_enabled;                  // Queue samples for the front end. Set before starting the core.
+extern std::atomic<bool> emulation_running;        // Cleared by the front end to stop the core.
+extern std::atomic<int> color_scheme;              // Colour scheme requested by the front end, applied before the next frame.
+extern bool bg_cache_enabled;                      // Draw the background from pre-rendered maps. Set before starting the core.
+extern bool throttle_enabled;                      // Run at real time speed. Cleared for headless runs. Set before starting the core.
+extern int frame_limit;                            // Stop the core after this many frames, 0 for no limit. Set before starting the core.
+extern bool frame_hashes_enabled;                  // Keep the hash of every published frame. Set before starting the core.
+extern std::vector<uint64_t> frame_hashes;         // Hashes of the published frames, in order. Read once the core has stopped.
+extern bool audio_hashes_enabled;                  // Keep a hash of each frame's audio samples. Set before starting the core.
+extern std::vector<uint64_t> audio_hashes;         // Hashes of every frame's samples, in order. Read once the core has stopped.
+
+// Test rom results. Each of these stops the core when it happens.
+extern bool breakpoint_stop_enabled;               // Stop at LD B,B with mooneye's pass or fail signature, which its test roms end on. Set before starting the core.
+extern bool breakpoint_hit;                        // Set when the core stopped there.
+extern bool core_stopped;                          // Set by stop_core().
+extern uint64_t stop_frame_hash;                   // Stop once a frame with this hash is published, 0 for never. Set before starting the core.
+extern std::atomic<bool> stop_frame_seen;          // Set when it was.
+
+// Audio telemetry, readable from any thread.
+extern std::atomic<int> audio_fill;             // Samples still queued when the last frame was pushed.
+extern std::atomic<int> audio_rate_ppm;         // Current output rate adjustment, in parts per million.
+extern std::atomic<uint32_t> audio_underruns;   // Samples the front end had to play as silence.
+extern std::atomic<uint32_t> audio_overruns;    // Samples dropped because audio_queue was full.
+
+// Benchmark counters. subsystem_time is only kept with
+// subsystem_timing_enabled, which reads the time stamp counter around every
+// step of the frame loop and slows the core down accordingly.
+enum subsystem {
+	SUBSYSTEM_CPU,        // Instructions, with the memory accesses they make.
+	SUBSYSTEM_TIMERS,     // DIV, TIMA and the serial port.
+	SUBSYSTEM_PPU,        // Mode changes, and drawing when the renderer has no thread of its own.
+	SUBSYSTEM_INTERUPTS,  // Checking for and dispatching interupts.
+	SUBSYSTEM_APU,        // Synthesis and resampling at the end of each frame.
+	SUBSYSTEMS,
+};
+extern int frame_count;                      // Frames emulated so far.
+extern uint64_t emulated_cycles;             // Cycles run before the current frame.
+extern uint64_t instruction_count;           // Instructions run so far.
+extern bool subsystem_timing_enabled;        // Set before starting the core.
+extern uint64_t subsystem_time[SUBSYSTEMS];  // Time stamp counter ticks spent in each.
+
+// Rom Loading
+void read_rom(char* filename);
+void load_bootrom(char* filename);
+void detect_banking_mode();
+void load_movie(char* filename);  // Reads key presses to replay at fixed frames.
+
+void setup_color_palettes();  // Decodes every palette register value for each colour scheme.
+void setup_apu();             // Builds the band-limited step tables for the APU.
+void print_registers();       // Prints registers info.
+bool mooneye_passed();        // Whether B, C, D, E, H and L hold mooneye's pass signature 3, 5, 8, 13, 21, 34.
+bool mooneye_failed();        // Whether they hold its fail signature, 0x42 in all of them.
+
+// Register file, for tools that drive the CPU directly.
+struct cpu_state {
+	uint8_t a, f, b, c, d, e, h, l;
+	uint16_t sp, pc;
+	bool ime;
+};
+cpu_state get_cpu_state();
+void set_cpu_state(const cpu_state& state);
+void cpu_cycle();  // Runs one instruction.
+
+#ifdef FLAT_BUS
+// Built with FLAT_BUS (the single step test runner), read_byte and
+// write_byte see memory as 64K of plain RAM and log every access.
+struct bus_access {
+	uint16_t address;
+	uint8_t value;
+	bool write;
+};
+const int BUS_LOG_SIZE = 16;  // Far more than one instruction makes.
+extern uint8_t memory[65536];
+extern bus_access bus_log[BUS_LOG_SIZE];
+extern int bus_log_count;     // Cleared by the caller before each instruction.
+#endif
+
+void emulate_frame();  // Runs the cpu for one frames worth of cycles.
+void run_emulation();  // Emulation thread. Runs frames until emulation_running is cleared or frame_limit is reached.
+void stop_core();      // Stops the core after the current instruction rather than at the end of the frame. Core thread only.
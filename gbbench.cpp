@@ -0,0 +1,673 @@
+// Microbenchmarks for the hot paths of the core: instruction dispatch, the
+// ALU helpers, bus reads and writes per memory region, the renderer's
+// drawing functions, the per frame pixel hashing and copy, and the APU.
+// Each benchmark is run once to warm up and then timed over a number of
+// repetitions, reporting ns per operation with the spread between them.
+//
+// With --roms it runs whole roms instead, through emu --benchmark one after
+// the other on the same CPU, and reports emulated MIPS, frames per second,
+// the multiple of real time, peak memory and where the time goes. The list
+// has one rom per line, "<rom> [movie]", the movie giving the input.
+//
+// Links the same core sources as emu, without SDL. Internals that have no
+// header are declared here the same way the core's own files do.
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "apu.h"
+#include "gameboy.h"
+#include "hash.h"
+#include "ppu.h"
+#include "renderer.h"
+#include "runner.h"
+
+using namespace std;
+
+// From gameboy.cpp.
+extern uint8_t* rom;
+extern bool enable_boot;
+uint8_t read_byte(uint16_t location);
+void write_byte(uint8_t data, uint16_t location);
+void add_byte(uint8_t value);
+uint16_t add_2_byte(uint16_t a, uint16_t b);
+void sub_byte(uint8_t value);
+void adc(uint8_t value);
+void Sbc(uint8_t value);
+void cp(uint8_t value);
+uint8_t inc(uint8_t value);
+uint8_t dec(uint8_t value);
+void And(uint8_t value);
+void Or(uint8_t value);
+void Xor(uint8_t value);
+void DAA();
+uint8_t RotByteLeft(uint8_t number);
+uint8_t Rotate_Right_Carry(uint8_t number);
+uint8_t Shift_Right_A(uint8_t number);
+uint8_t Swap(uint8_t number);
+uint8_t Bit_Test(uint8_t bit, uint8_t number);
+
+// From renderer.cpp.
+extern uint8_t renderer_vram[0x2000];
+extern bool tile_dirty[384];
+extern bool tiles_dirty;
+void load_tiles();
+void render_tile_map_line(uint8_t currentline, const line_registers& regs);
+void render_cached_tile_map_line(uint8_t currentline, const line_registers& regs);
+void render_sprites(const uint8_t* oam, const line_registers* lines);
+
+// One benchmark's timings, in ns per operation.
+struct benchmark_result {
+	string name;
+	long long ops;  // Operations per repetition.
+	double mean;
+	double median;
+	double min;
+	double stddev;
+};
+
+// One rom of the macro benchmark, with the figures of its median run.
+struct rom_job {
+	string rom;
+	string movie;
+	bool ok;
+	string error;  // Last line emu printed, when it failed.
+	int frames;
+	unsigned long long instructions;
+	unsigned long long cycles;
+	double seconds;
+	double mips;
+	double fps;
+	double realtime;  // Emulated seconds per second.
+	unsigned long long peak_rss_kb;
+	double subsystem_share[SUBSYSTEMS];  // Percent, from a separate --subsystems run.
+};
+
+// Options
+int repetitions = 0;        // 0 for the default, 10 for microbenchmarks and 3 for roms.
+double scale = 1;           // Multiplies every benchmark's operation count.
+const char* filter = NULL;  // Only run benchmarks whose name contains this.
+string emu_path;            // Defaults to emu next to this program.
+string bootrom_path;        // Passed on to emu when set.
+int frames = 3600;          // Frames to run each rom for.
+int pin_cpu = -1;           // CPU to run emu on, -1 to leave it to the OS.
+
+vector<benchmark_result> results;
+vector<rom_job> jobs;
+volatile uint32_t bench_sink;  // Results are folded into this so they are not optimised away.
+
+// Test data.
+uint8_t bench_rom[0x8000 * 4];
+uint8_t bench_oam[0xA0];
+line_registers bench_lines[SCREEN_HEIGHT];
+const uint32_t bench_palette[4] = { 0xFFFFFFFF, 0xFFB4B4B4, 0xFF6E6E6E, 0xFF000000 };
+uint32_t bench_texture[SCREEN_HEIGHT][SCREEN_WIDTH + 16];  // Padded pitch, like a streaming texture.
+
+void usage();           // Prints the command line options and exits.
+void setup_bench();     // Fills the rom, VRAM, OAM and line registers with test data.
+void setup_channels();  // Turns all four sound channels on.
+void fill_opcode_stream(const vector<vector<uint8_t>>& instructions);  // Fills work RAM with random picks from instructions, jumping back at the end.
+void write_json(const char* filename);
+
+void read_rom_list(const char* filename);         // Fills jobs from the --roms list.
+bool run_emu(rom_job& job, bool subsystems);      // Runs emu --benchmark once and reads its figures into job.
+void run_rom(rom_job& job);                       // Runs one rom repetitions times and keeps the median.
+void write_rom_json(const char* filename);
+
+// Times body(ops) once for warm-up and then repetitions times.
+template <typename Body>
+void run_benchmark(const char* name, long long ops, Body body) {
+	if (filter && !strstr(name, filter)) {
+		return;
+	}
+	ops = max(1LL, (long long)(ops * scale));
+
+	body(ops);
+	vector<double> times;
+	for (int i = 0; i < repetitions; i++) {
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		body(ops);
+		double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+		times.push_back(ns / ops);
+	}
+
+	benchmark_result result;
+	result.name = name;
+	result.ops = ops;
+	sort(times.begin(), times.end());
+	result.min = times[0];
+	result.median = times[times.size() / 2];
+	double sum = 0;
+	for (size_t i = 0; i < times.size(); i++) {
+		sum += times[i];
+	}
+	result.mean = sum / times.size();
+	double variance = 0;
+	for (size_t i = 0; i < times.size(); i++) {
+		variance += (times[i] - result.mean) * (times[i] - result.mean);
+	}
+	result.stddev = times.size() > 1 ? sqrt(variance / (times.size() - 1)) : 0;
+	results.push_back(result);
+
+	printf("%-36s %14.2f ns/op  median %14.2f  min %14.2f  +/- %5.1f%%\n", name, result.mean, result.median,
+		result.min, result.mean > 0 ? 100 * result.stddev / result.mean : 0);
+}
+
+int main(int argc, char** argv) {
+	const char* json_file = NULL;
+	const char* rom_list = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--reps") && i + 1 < argc) {
+			repetitions = max(1, atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "--scale") && i + 1 < argc) {
+			scale = atof(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+			filter = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+			json_file = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--roms") && i + 1 < argc) {
+			rom_list = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--emu") && i + 1 < argc) {
+			emu_path = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--bootrom") && i + 1 < argc) {
+			bootrom_path = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+			frames = max(1, atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "--pin") && i + 1 < argc) {
+			pin_cpu = atoi(argv[++i]);
+		}
+		else {
+			usage();
+		}
+	}
+
+	if (rom_list) {
+		if (repetitions == 0) {
+			repetitions = 3;
+		}
+		if (emu_path.empty()) {
+			emu_path = sibling_program(argv[0], "emu");
+		}
+
+		read_rom_list(rom_list);
+		bool failed = false;
+		for (size_t i = 0; i < jobs.size(); i++) {
+			run_rom(jobs[i]);
+			failed |= !jobs[i].ok;
+		}
+		if (json_file) {
+			write_rom_json(json_file);
+		}
+		return failed ? 2 : 0;
+	}
+
+	if (repetitions == 0) {
+		repetitions = 10;
+	}
+	setup_bench();
+
+	// Instruction dispatch. Work RAM is filled with a random stream of
+	// instructions that neither branch nor write through HL, ending in a jump
+	// back to the start, and cpu_cycle() is run over it.
+	vector<vector<uint8_t>> nops = { { 0x00 } };
+	vector<vector<uint8_t>> loads;
+	vector<vector<uint8_t>> alu;
+	vector<vector<uint8_t>> mixed;
+	for (int op = 0x40; op < 0x80; op++) {
+		if (op < 0x70 || op > 0x77) {
+			loads.push_back({ (uint8_t)op });
+		}
+	}
+	for (int op = 0x80; op < 0xC0; op++) {
+		alu.push_back({ (uint8_t)op });
+	}
+	mixed = loads;
+	mixed.insert(mixed.end(), alu.begin(), alu.end());
+	const uint8_t immediates[] = { 0x06, 0x0E, 0x16, 0x1E, 0x3E, 0xC6, 0xCE, 0xD6, 0xDE, 0xE6, 0xEE, 0xF6, 0xFE };
+	for (uint8_t op : immediates) {
+		mixed.push_back({ op, 0x5A });
+	}
+	const uint8_t singles[] = { 0x03, 0x04, 0x05, 0x07, 0x0B, 0x0C, 0x0D, 0x0F, 0x13, 0x17, 0x1F, 0x27, 0x2F, 0x37, 0x3F };
+	for (uint8_t op : singles) {
+		mixed.push_back({ op });
+	}
+	mixed.push_back({ 0x01, 0x34, 0x12 });
+	mixed.push_back({ 0x11, 0x78, 0x56 });
+	for (int op = 0; op < 0x100; op++) {
+		// CB ops on (HL) write back, except BIT.
+		if ((op & 7) != 6 || (op >= 0x40 && op < 0x80)) {
+			mixed.push_back({ 0xCB, (uint8_t)op });
+		}
+	}
+
+	auto dispatch = [](long long ops) {
+		cpu_state state = {};
+		state.pc = 0xC000;
+		state.sp = 0xDFF0;
+		state.h = 0xC1;
+		set_cpu_state(state);
+		for (long long i = 0; i < ops; i++) {
+			cpu_cycle();
+		}
+		bench_sink += get_cpu_state().a;
+		cycle_count = 0;  // Left where the APU expects a frame to start.
+	};
+	fill_opcode_stream(nops);
+	run_benchmark("dispatch/nop", 2000000, dispatch);
+	fill_opcode_stream(loads);
+	run_benchmark("dispatch/ld_r_r", 2000000, dispatch);
+	fill_opcode_stream(alu);
+	run_benchmark("dispatch/alu_a_r", 2000000, dispatch);
+	fill_opcode_stream(mixed);
+	run_benchmark("dispatch/mixed", 2000000, dispatch);
+
+	// ALU helpers, on a spread of operands.
+	const long long alu_ops = 5000000;
+	run_benchmark("alu/add_byte", alu_ops, [](long long ops) { for (long long i = 0; i < ops; i++) add_byte((uint8_t)i); bench_sink += get_cpu_state().a; });
+	run_benchmark("alu/add_2_byte", alu_ops, [](long long ops) { uint16_t v = 0; for (long long i = 0; i < ops; i++) v = add_2_byte(v, (uint16_t)(i * 0x0101)); bench_sink += v; });
+	run_benchmark("alu/sub_byte", alu_ops, [](long long ops) { for (long long i = 0; i < ops; i++) sub_byte((uint8_t)i); bench_sink += get_cpu_state().a; });
+	run_benchmark("alu/adc", alu_ops, [](long long ops) { for (long long i = 0; i < ops; i++) adc((uint8_t)i); bench_sink += get_cpu_state().a; });
+	run_benchmark("alu/Sbc", alu_ops, [](long long ops) { for (long long i = 0; i < ops; i++) Sbc((uint8_t)i); bench_sink += get_cpu_state().a; });
+	run_benchmark("alu/cp", alu_ops, [](long long ops) { for (long long i = 0; i < ops; i++) cp((uint8_t)i); bench_sink += get_cpu_state().f; });
+	run_benchmark("alu/inc", alu_ops, [](long long ops) { uint8_t v = 0; for (long long i = 0; i < ops; i++) v = inc(v); bench_sink += v; });
+	run_benchmark("alu/dec", alu_ops, [](long long ops) { uint8_t v = 0; for (long long i = 0; i < ops; i++) v = dec(v); bench_sink += v; });
+	run_benchmark("alu/And", alu_ops, [](long long ops) { for (long long i = 0; i < ops; i++) And((uint8_t)~i); bench_sink += get_cpu_state().a; });
+	run_benchmark("alu/Or", alu_ops, [](long long ops) { for (long long i = 0; i < ops; i++) Or((uint8_t)i); bench_sink += get_cpu_state().a; });
+	run_benchmark("alu/Xor", alu_ops, [](long long ops) { for (long long i = 0; i < ops; i++) Xor((uint8_t)i); bench_sink += get_cpu_state().a; });
+	run_benchmark("alu/DAA", alu_ops, [](long long ops) { for (long long i = 0; i < ops; i++) { add_byte((uint8_t)i); DAA(); } bench_sink += get_cpu_state().a; });
+	run_benchmark("alu/RotByteLeft", alu_ops, [](long long ops) { uint8_t v = 1; for (long long i = 0; i < ops; i++) v = RotByteLeft(v); bench_sink += v; });
+	run_benchmark("alu/Rotate_Right_Carry", alu_ops, [](long long ops) { uint8_t v = 1; for (long long i = 0; i < ops; i++) v = Rotate_Right_Carry(v); bench_sink += v; });
+	run_benchmark("alu/Shift_Right_A", alu_ops, [](long long ops) { uint8_t v = 0; for (long long i = 0; i < ops; i++) v = Shift_Right_A(v ^ (uint8_t)i); bench_sink += v; });
+	run_benchmark("alu/Swap", alu_ops, [](long long ops) { uint8_t v = 0x12; for (long long i = 0; i < ops; i++) v = Swap(v + 1); bench_sink += v; });
+	run_benchmark("alu/Bit_Test", alu_ops, [](long long ops) { uint32_t v = 0; for (long long i = 0; i < ops; i++) v += Bit_Test(i & 7, (uint8_t)i); bench_sink += v; });
+
+	// Bus accesses, walking through each region.
+	struct bus_region {
+		const char* read_name;
+		const char* write_name;
+		uint16_t base;
+		uint16_t mask;
+		uint8_t data_mask;  // Keeps rom bank numbers within bench_rom.
+	};
+	const bus_region regions[] = {
+		{ "bus/read_rom0", "bus/write_rom_bank", 0x0000, 0x3FFF, 0x03 },
+		{ "bus/read_romx", "bus/write_rom", 0x4000, 0x3FFF, 0xFF },
+		{ "bus/read_vram", "bus/write_vram", 0x8000, 0x1FFF, 0xFF },
+		{ "bus/read_cart_ram", "bus/write_cart_ram", 0xA000, 0x1FFF, 0xFF },
+		{ "bus/read_wram", "bus/write_wram", 0xC000, 0x1FFF, 0xFF },
+		{ "bus/read_oam", "bus/write_oam", 0xFE00, 0x007F, 0xFF },
+		{ "bus/read_apu", "bus/write_apu", 0xFF10, 0x000F, 0xFF },
+		{ "bus/read_io", "bus/write_io", 0xFF47, 0x0000, 0xFF },
+		{ "bus/read_hram", "bus/write_hram", 0xFF80, 0x003F, 0xFF },
+	};
+	const long long bus_ops = 5000000;
+	for (const bus_region& region : regions) {
+		uint16_t base = region.base;
+		uint16_t mask = region.mask;
+		uint8_t data_mask = region.data_mask;
+		run_benchmark(region.read_name, bus_ops, [=](long long ops) {
+			uint32_t sum = 0;
+			for (long long i = 0; i < ops; i++) {
+				sum += read_byte(base + (i & mask));
+			}
+			bench_sink += sum;
+		});
+		run_benchmark(region.write_name, bus_ops, [=](long long ops) {
+			for (long long i = 0; i < ops; i++) {
+				write_byte((uint8_t)(1 + ((i * 7) & data_mask)), base + (i & mask));
+			}
+		});
+	}
+	// Put back what the writes changed.
+	write_byte(1, 0x2000);
+	memset(memory + 0x8000, 0, 0x2000);
+
+	// Renderer.
+	run_benchmark("render/load_tiles", 2000, [](long long ops) {
+		for (long long i = 0; i < ops; i++) {
+			memset(tile_dirty, 1, sizeof(tile_dirty));
+			tiles_dirty = true;
+			load_tiles();
+		}
+	});
+	run_benchmark("render/render_tile_map_line", 200000, [](long long ops) {
+		for (long long i = 0; i < ops; i++) {
+			render_tile_map_line((uint8_t)(i % SCREEN_HEIGHT), bench_lines[i % SCREEN_HEIGHT]);
+		}
+	});
+	run_benchmark("render/render_cached_tile_map_line", 200000, [](long long ops) {
+		for (long long i = 0; i < ops; i++) {
+			render_cached_tile_map_line((uint8_t)(i % SCREEN_HEIGHT), bench_lines[i % SCREEN_HEIGHT]);
+		}
+	});
+	run_benchmark("render/render_sprites", 20000, [](long long ops) {
+		for (long long i = 0; i < ops; i++) {
+			render_sprites(bench_oam, bench_lines);
+		}
+	});
+
+	// What happens to every finished frame on its way to the screen: the line
+	// and frame hashes publish_frame() takes, and display_buffer()'s copy of
+	// the changed lines into the texture, here all of them.
+	run_benchmark("frame/hash_lines", 20000, [](long long ops) {
+		uint64_t line_hash[SCREEN_HEIGHT];
+		for (long long i = 0; i < ops; i++) {
+			for (int y = 0; y < SCREEN_HEIGHT; y++) {
+				line_hash[y] = xxhash64(frame_buffer[y], SCREEN_WIDTH * sizeof(uint32_t));
+			}
+			bench_sink += (uint32_t)xxhash64(line_hash, sizeof(line_hash));
+		}
+	});
+	run_benchmark("frame/texture_copy", 20000, [](long long ops) {
+		for (long long i = 0; i < ops; i++) {
+			for (int y = 0; y < SCREEN_HEIGHT; y++) {
+				memcpy(bench_texture[y], frame_buffer[y], SCREEN_WIDTH * sizeof(uint32_t));
+			}
+			bench_sink += bench_texture[i % SCREEN_HEIGHT][0];
+		}
+	});
+
+	// APU, one op being an emulated second of all four channels playing,
+	// synthesis and resampling to AUDIO_SAMPLE_RATE included.
+	setup_channels();
+	run_benchmark("apu/emulated_second", 20, [](long long ops) {
+		for (long long i = 0; i < ops; i++) {
+			for (int frame = 0; frame < CLOCKSPEED / CYCLES_PER_FRAME; frame++) {
+				// Retrigger a channel now and then so levels keep changing.
+				cycle_count = CYCLES_PER_FRAME / 2;
+				write_apu(0x87, 0xFF14 + 5 * (frame & 3));
+				cycle_count = CYCLES_PER_FRAME;
+				end_apu_frame();
+			}
+		}
+		cycle_count = 0;
+	});
+
+	if (json_file) {
+		write_json(json_file);
+	}
+	return 0;
+}
+
+void usage() {
+	printf("Usage: gbbench [options]\n"
+		"  --reps N         Timed repetitions of each benchmark (default: 10, 3 with --roms).\n"
+		"  --scale X        Multiply the work in each repetition by X.\n"
+		"  --filter TEXT    Only run benchmarks whose name contains TEXT.\n"
+		"  --json FILE      Write the results as JSON.\n"
+		"  --roms LIST      Benchmark the roms in LIST through emu instead.\n"
+		"  --emu PATH       Emulator to run (default: emu next to gbbench).\n"
+		"  --bootrom FILE   Boot rom passed on to the emulator.\n"
+		"  --frames N       Frames to run each rom for (default: 3600).\n"
+		"  --pin CPU        Run the emulator on logical CPU number CPU only.\n");
+	exit(1);
+}
+
+// Small deterministic generator, so the test data is the same on every run.
+uint8_t next_random(uint32_t& seed) {
+	seed = seed * 1664525 + 1013904223;
+	return (uint8_t)(seed >> 24);
+}
+
+void setup_bench() {
+	uint32_t seed = 12345;
+
+	for (size_t i = 0; i < sizeof(bench_rom); i++) {
+		bench_rom[i] = next_random(seed);
+	}
+	rom = bench_rom;
+	enable_boot = false;
+
+	setup_color_palettes();
+	setup_apu();
+
+	// Tiles and both maps, decoded once so the line renderers have something
+	// to draw.
+	for (int i = 0; i < 0x2000; i++) {
+		renderer_vram[i] = next_random(seed);
+	}
+	memset(tile_dirty, 1, sizeof(tile_dirty));
+	tiles_dirty = true;
+	load_tiles();
+
+	for (int sprite = 0; sprite < 40; sprite++) {
+		bench_oam[sprite * 4] = 16 + (sprite * 29) % SCREEN_HEIGHT;
+		bench_oam[sprite * 4 + 1] = 8 + (sprite * 37) % SCREEN_WIDTH;
+		bench_oam[sprite * 4 + 2] = next_random(seed);
+		bench_oam[sprite * 4 + 3] = next_random(seed) & 0x70;
+	}
+
+	// Background, window and sprites on, scrolling down the screen.
+	for (int y = 0; y < SCREEN_HEIGHT; y++) {
+		line_registers& line = bench_lines[y];
+		line.lcdc = 0xF3;
+		line.scroll_y = (uint8_t)(y / 2);
+		line.scroll_x = (uint8_t)(y * 3);
+		line.window_y = 100;
+		line.window_x = 87;
+		line.bg_palette = bench_palette;
+		line.obj_palette[0] = bench_palette;
+		line.obj_palette[1] = bench_palette;
+		line.vram_version = 0;
+	}
+}
+
+void setup_channels() {
+	uint32_t seed = 999;
+	cycle_count = 0;
+
+	// Power cycle to clear whatever the bus benchmarks left behind.
+	write_apu(0x00, 0xFF26);
+	write_apu(0x80, 0xFF26);
+	write_apu(0x77, 0xFF24);
+	write_apu(0xFF, 0xFF25);
+	write_apu(0x00, 0xFF10);  // No sweep.
+	for (int i = 0xFF30; i < 0xFF40; i++) {
+		write_apu(next_random(seed), i);
+	}
+	write_apu(0x80, 0xFF1A);
+
+	// Different pitches, no length counters and no envelopes, so nothing
+	// goes quiet.
+	const uint8_t channel_base[4] = { 0x10, 0x15, 0x1A, 0x1F };
+	for (int channel = 0; channel < 4; channel++) {
+		uint16_t base = 0xFF00 + channel_base[channel];
+		write_apu(0x80, base + 1);
+		write_apu(channel == 2 ? 0x20 : 0xF0, base + 2);
+		write_apu((uint8_t)(0x40 + channel * 0x30), base + 3);
+		write_apu(0x86, base + 4);
+	}
+}
+
+void fill_opcode_stream(const vector<vector<uint8_t>>& instructions) {
+	uint32_t seed = 54321;
+	uint16_t address = 0xC000;
+	while (address < 0xDF00) {
+		seed = seed * 1664525 + 1013904223;
+		const vector<uint8_t>& instruction = instructions[(seed >> 16) % instructions.size()];
+		for (uint8_t byte : instruction) {
+			memory[address++] = byte;
+		}
+	}
+	memory[address++] = 0xC3;  // JP 0xC000
+	memory[address++] = 0x00;
+	memory[address++] = 0xC0;
+}
+
+void write_json(const char* filename) {
+	FILE* file = fopen(filename, "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", filename);
+		exit(1);
+	}
+
+	fprintf(file, "{\n  \"repetitions\": %d,\n  \"benchmarks\": [", repetitions);
+	for (size_t i = 0; i < results.size(); i++) {
+		const benchmark_result& result = results[i];
+		fprintf(file, "%s\n    {\"name\": \"%s\", \"ops\": %lld, \"ns_per_op\": %.3f, \"median\": %.3f, \"min\": %.3f, \"stddev\": %.3f}",
+			i ? "," : "", result.name.c_str(), result.ops, result.mean, result.median, result.min, result.stddev);
+	}
+	fprintf(file, "\n  ]\n}\n");
+	fclose(file);
+}
+
+void read_rom_list(const char* filename) {
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		cerr << "Invalid List File!" << endl;
+		exit(1);
+	}
+
+	string line;
+	while (getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		vector<string> fields = split_fields(line);
+		if (fields.empty()) {
+			continue;
+		}
+		if (fields.size() > 2) {
+			cerr << "Invalid List Line: " << line << endl;
+			exit(1);
+		}
+
+		rom_job job = {};
+		job.rom = fields[0];
+		if (fields.size() == 2) {
+			job.movie = fields[1];
+		}
+		jobs.push_back(job);
+	}
+}
+
+bool run_emu(rom_job& job, bool subsystems) {
+	string command = quote(emu_path) + " --benchmark --frames " + to_string(frames);
+	if (subsystems) {
+		command += " --subsystems";
+	}
+	if (pin_cpu >= 0) {
+		command += " --pin " + to_string(pin_cpu);
+	}
+	if (!bootrom_path.empty()) {
+		command += " --bootrom " + quote(bootrom_path);
+	}
+	if (!job.movie.empty()) {
+		command += " --movie " + quote(job.movie);
+	}
+	command += " " + quote(job.rom);
+
+	FILE* output = start_command(command);
+	if (output == NULL) {
+		job.error = "could not start " + emu_path;
+		return false;
+	}
+
+	// emu prints "Benchmark: " and, with --subsystems, "Subsystems: " lines
+	// of name value pairs.
+	char line[512];
+	bool reported = false;
+	string last_line;
+	while (fgets(line, sizeof(line), output)) {
+		line[strcspn(line, "\r\n")] = 0;
+		if (!strncmp(line, "Benchmark: ", 11)) {
+			reported = sscanf(line + 11, "frames %d instructions %llu cycles %llu seconds %lf mips %lf fps %lf realtime %lf peak_rss_kb %llu",
+				&job.frames, &job.instructions, &job.cycles, &job.seconds, &job.mips, &job.fps, &job.realtime,
+				&job.peak_rss_kb) == 8;
+		}
+		else if (!strncmp(line, "Subsystems: ", 12)) {
+			double* share = job.subsystem_share;
+			sscanf(line + 12, "cpu %lf timers %lf ppu %lf interupts %lf apu %lf", &share[SUBSYSTEM_CPU],
+				&share[SUBSYSTEM_TIMERS], &share[SUBSYSTEM_PPU], &share[SUBSYSTEM_INTERUPTS], &share[SUBSYSTEM_APU]);
+		}
+		else if (line[0]) {
+			last_line = line;
+		}
+	}
+	int status = finish_command(output);
+
+	if (!reported) {
+		job.error = last_line.empty() ? "exit status " + to_string(status) : last_line;
+		return false;
+	}
+	return true;
+}
+
+void run_rom(rom_job& job) {
+	// The speed runs, without subsystem timing slowing them down.
+	vector<rom_job> runs;
+	for (int i = 0; i < repetitions; i++) {
+		rom_job run = job;
+		if (!run_emu(run, false)) {
+			job.error = run.error;
+			printf("%-40s ERROR %s\n", job.rom.c_str(), job.error.c_str());
+			return;
+		}
+		runs.push_back(run);
+	}
+	sort(runs.begin(), runs.end(), [](const rom_job& a, const rom_job& b) { return a.seconds < b.seconds; });
+	job = runs[runs.size() / 2];
+
+	rom_job timed = job;
+	if (!run_emu(timed, true)) {
+		job.error = timed.error;
+		printf("%-40s ERROR %s\n", job.rom.c_str(), job.error.c_str());
+		return;
+	}
+	memcpy(job.subsystem_share, timed.subsystem_share, sizeof(job.subsystem_share));
+	job.ok = true;
+
+	const double* share = job.subsystem_share;
+	printf("%-40s %8.2f MIPS %9.1f fps %7.2fx real time %8llu KB  cpu %.1f%% timers %.1f%% ppu %.1f%% interupts %.1f%% apu %.1f%%\n",
+		job.rom.c_str(), job.mips, job.fps, job.realtime, job.peak_rss_kb, share[SUBSYSTEM_CPU], share[SUBSYSTEM_TIMERS],
+		share[SUBSYSTEM_PPU], share[SUBSYSTEM_INTERUPTS], share[SUBSYSTEM_APU]);
+}
+
+void write_rom_json(const char* filename) {
+	FILE* file = fopen(filename, "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", filename);
+		exit(1);
+	}
+
+	// sessions_per_core is how many copies of the rom one CPU could run at
+	// full speed, going by the real time multiple.
+	fprintf(file, "{\n  \"frames\": %d,\n  \"repetitions\": %d,\n  \"pinned_cpu\": %d,\n  \"roms\": [", frames,
+		repetitions, pin_cpu);
+	for (size_t i = 0; i < jobs.size(); i++) {
+		const rom_job& job = jobs[i];
+		fprintf(file, "%s\n    {\"rom\": \"%s\", ", i ? "," : "", escape_json(job.rom).c_str());
+		if (!job.ok) {
+			fprintf(file, "\"error\": \"%s\"}", escape_json(job.error).c_str());
+			continue;
+		}
+		const double* share = job.subsystem_share;
+		fprintf(file, "\"frames\": %d, \"instructions\": %llu, \"cycles\": %llu, \"seconds\": %.6f, \"mips\": %.3f, "
+			"\"fps\": %.2f, \"realtime\": %.3f, \"sessions_per_core\": %d, \"peak_rss_kb\": %llu, "
+			"\"subsystems\": {\"cpu\": %.2f, \"timers\": %.2f, \"ppu\": %.2f, \"interupts\": %.2f, \"apu\": %.2f}}",
+			job.frames, job.instructions, job.cycles, job.seconds, job.mips, job.fps, job.realtime, (int)job.realtime,
+			job.peak_rss_kb, share[SUBSYSTEM_CPU], share[SUBSYSTEM_TIMERS], share[SUBSYSTEM_PPU],
+			share[SUBSYSTEM_INTERUPTS], share[SUBSYSTEM_APU]);
+	}
+	fprintf(file, "\n  ]\n}\n");
+	fclose(file);
+}
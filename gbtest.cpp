@@ -0,0 +1,383 @@
+// Conformance test runner. Runs every rom in a directory (blargg, mooneye,
+// acid2, ...) headless through emu, several at a time, and writes the results
+// as JUnit XML and JSON. Like regress, each rom gets its own emu process
+// because the core keeps all of its state in globals.
+//
+// emu stops each rom as soon as it has a result: a pass or fail string over
+// serial (blargg), LD B,B with the register signature (mooneye), or a frame
+// with the expected hash (acid2 and other screenshot tests). Roms that never
+// get there fail when their cycle budget runs out, or when the wall clock
+// timeout does for roms that hang the core.
+//
+// An optional gbtest.txt in the directory sets per rom budgets and expected
+// frame hashes, one rom per line: "<rom> <cycles|-> [frame hash]", with the
+// rom relative to the directory. Lines starting with # are skipped.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "runner.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+enum test_status {
+	TEST_PASSED,
+	TEST_FAILED,
+	TEST_ERROR,  // emu did not report a result at all.
+};
+
+// One rom to run.
+struct test_job {
+	string name;        // Path relative to the test directory, with forward slashes.
+	string rom;
+	uint64_t cycles;    // Cycle budget.
+	string frame_hash;  // Expected frame, empty for none.
+
+	test_status status;
+	string message;     // Why it failed, or what it passed on.
+	string output;      // Everything emu printed.
+	double time;        // Wall clock seconds.
+};
+
+// Options
+string emu_path;                            // Defaults to emu next to this program.
+string bootrom_path;                        // Passed on to emu when set.
+uint64_t default_cycles = 60ull * 4194304;  // 60 emulated seconds.
+int timeout = 60;                           // Wall clock seconds per rom.
+vector<string> pass_strings;                // Serial pass strings, "Passed" when none are given.
+vector<string> fail_strings;                // Serial fail strings, "Failed" when none are given.
+unsigned int thread_count = 0;
+
+vector<test_job> jobs;
+
+void usage();                                     // Prints the command line options and exits.
+void find_roms(const string& directory);          // Fills jobs with every .gb and .gbc under directory.
+void read_manifest(const string& directory);      // Applies gbtest.txt to jobs, if there is one.
+void run_job(test_job& job);                      // Runs emu on one rom and records the result.
+void write_junit(const char* filename, double total_time);
+void write_json(const char* filename, double total_time);
+string escape_xml(const string& text);
+
+int main(int argc, char** argv) {
+	const char* directory = NULL;
+	const char* junit_file = NULL;
+	const char* json_file = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+			thread_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--emu") && i + 1 < argc) {
+			emu_path = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--bootrom") && i + 1 < argc) {
+			bootrom_path = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--cycles") && i + 1 < argc) {
+			default_cycles = strtoull(argv[++i], NULL, 10);
+		}
+		else if (!strcmp(argv[i], "--timeout") && i + 1 < argc) {
+			timeout = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--pass") && i + 1 < argc) {
+			pass_strings.push_back(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--fail") && i + 1 < argc) {
+			fail_strings.push_back(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--junit") && i + 1 < argc) {
+			junit_file = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+			json_file = argv[++i];
+		}
+		else if (argv[i][0] == '-' || directory) {
+			usage();
+		}
+		else {
+			directory = argv[i];
+		}
+	}
+	if (!directory) {
+		usage();
+	}
+	if (pass_strings.empty()) {
+		pass_strings.push_back("Passed");
+	}
+	if (fail_strings.empty()) {
+		fail_strings.push_back("Failed");
+	}
+
+	if (emu_path.empty()) {
+		emu_path = sibling_program(argv[0], "emu");
+	}
+	if (thread_count == 0) {
+		thread_count = default_thread_count();
+	}
+
+	find_roms(directory);
+	read_manifest(directory);
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	run_jobs(jobs.size(), thread_count, [](size_t i) { run_job(jobs[i]); });
+	double total_time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	int failed = 0;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		const test_job& job = jobs[i];
+		const char* status = job.status == TEST_PASSED ? "PASS" : job.status == TEST_FAILED ? "FAIL" : "ERROR";
+		printf("%-5s %s: %s (%.2fs)\n", status, job.name.c_str(), job.message.c_str(), job.time);
+		if (job.status != TEST_PASSED) {
+			failed++;
+		}
+	}
+	printf("%d passed, %d failed in %.2fs\n", (int)jobs.size() - failed, failed, total_time);
+
+	if (junit_file) {
+		write_junit(junit_file, total_time);
+	}
+	if (json_file) {
+		write_json(json_file, total_time);
+	}
+	return failed ? 1 : 0;
+}
+
+void usage() {
+	printf("Usage: gbtest [options] directory\n"
+		"  -j N              Run N roms at once (default: one per core).\n"
+		"  --emu PATH        Emulator to run (default: emu next to gbtest).\n"
+		"  --bootrom FILE    Boot rom passed on to the emulator.\n"
+		"  --cycles N        Cycle budget for roms gbtest.txt has none for (default: 60 seconds worth).\n"
+		"  --timeout S       Wall clock limit per rom in seconds (default: 60).\n"
+		"  --pass TEXT       Serial pass string (default: Passed). Can be repeated.\n"
+		"  --fail TEXT       Serial fail string (default: Failed). Can be repeated.\n"
+		"  --junit FILE      Write the results as JUnit XML.\n"
+		"  --json FILE       Write the results as JSON.\n");
+	exit(1);
+}
+
+void find_roms(const string& directory) {
+	error_code error;
+	fs::recursive_directory_iterator it(directory, error);
+	if (error) {
+		cerr << "Invalid Test Directory!" << endl;
+		exit(1);
+	}
+
+	for (; it != fs::recursive_directory_iterator(); it.increment(error)) {
+		if (!it->is_regular_file()) {
+			continue;
+		}
+		string extension = it->path().extension().string();
+		transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		if (extension != ".gb" && extension != ".gbc") {
+			continue;
+		}
+
+		test_job job;
+		job.name = fs::relative(it->path(), directory).generic_string();
+		job.rom = it->path().string();
+		job.cycles = default_cycles;
+		job.status = TEST_ERROR;
+		job.time = 0;
+		jobs.push_back(job);
+	}
+
+	// Same order every run, whatever order the file system lists them in.
+	sort(jobs.begin(), jobs.end(), [](const test_job& a, const test_job& b) { return a.name < b.name; });
+}
+
+void read_manifest(const string& directory) {
+	std::ifstream file((fs::path(directory) / "gbtest.txt").string());
+	if (!file.is_open()) {
+		return;
+	}
+
+	map<string, size_t> by_name;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		by_name[jobs[i].name] = i;
+	}
+
+	string line;
+	while (getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		vector<string> fields = split_fields(line);
+		if (fields.empty()) {
+			continue;
+		}
+		if (fields.size() < 2 || fields.size() > 3) {
+			cerr << "Invalid Manifest Line: " << line << endl;
+			exit(1);
+		}
+		if (!by_name.count(fields[0])) {
+			cerr << "Manifest Rom Not Found: " << fields[0] << endl;
+			exit(1);
+		}
+
+		test_job& job = jobs[by_name[fields[0]]];
+		if (fields[1] != "-") {
+			job.cycles = strtoull(fields[1].c_str(), NULL, 10);
+		}
+		if (fields.size() == 3) {
+			job.frame_hash = fields[2];
+		}
+	}
+}
+
+void run_job(test_job& job) {
+	// Serial output goes to stdout so it ends up in the report.
+	string command = quote(emu_path) + " --headless --serial - --mooneye --cycles " + to_string(job.cycles);
+	command += " --timeout " + to_string(timeout);
+	for (size_t i = 0; i < pass_strings.size(); i++) {
+		command += " --serial-pass " + quote(pass_strings[i]);
+	}
+	for (size_t i = 0; i < fail_strings.size(); i++) {
+		command += " --serial-fail " + quote(fail_strings[i]);
+	}
+	if (!job.frame_hash.empty()) {
+		command += " --stop-hash " + job.frame_hash;
+	}
+	if (!bootrom_path.empty()) {
+		command += " --bootrom " + quote(bootrom_path);
+	}
+	command += " " + quote(job.rom);
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	FILE* output = start_command(command);
+	if (output == NULL) {
+		job.message = "could not start " + emu_path;
+		return;
+	}
+
+	// emu ends with a "Test passed: ..." or "Test failed: ..." line. Without
+	// one, keep the last line as the error.
+	char line[512];
+	bool reported = false;
+	string last_line;
+	while (fgets(line, sizeof(line), output)) {
+		job.output += line;
+		line[strcspn(line, "\r\n")] = 0;
+		if (!strncmp(line, "Test passed: ", 13) || !strncmp(line, "Test failed: ", 13)) {
+			job.message = line + 13;
+			reported = true;
+		}
+		else if (line[0]) {
+			last_line = line;
+		}
+	}
+	int status = finish_command(output);
+	job.time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	if (!reported) {
+		job.status = TEST_ERROR;
+		job.message = last_line;
+	}
+	else {
+		job.status = status == 0 ? TEST_PASSED : TEST_FAILED;
+		if (job.message == "no result") {
+			job.message = "no result within " + to_string(job.cycles) + " cycles";
+		}
+	}
+}
+
+void write_junit(const char* filename, double total_time) {
+	FILE* file = fopen(filename, "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", filename);
+		exit(1);
+	}
+
+	int failures = 0;
+	int errors = 0;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		failures += jobs[i].status == TEST_FAILED;
+		errors += jobs[i].status == TEST_ERROR;
+	}
+
+	fprintf(file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	fprintf(file, "<testsuite name=\"gbtest\" tests=\"%d\" failures=\"%d\" errors=\"%d\" time=\"%.3f\">\n",
+		(int)jobs.size(), failures, errors, total_time);
+	for (size_t i = 0; i < jobs.size(); i++) {
+		const test_job& job = jobs[i];
+
+		// Directory as the class, so suites group the way they are laid out.
+		size_t slash = job.name.find_last_of('/');
+		string classname = slash == string::npos ? "gbtest" : job.name.substr(0, slash);
+		string name = slash == string::npos ? job.name : job.name.substr(slash + 1);
+
+		fprintf(file, "  <testcase classname=\"%s\" name=\"%s\" time=\"%.3f\">\n",
+			escape_xml(classname).c_str(), escape_xml(name).c_str(), job.time);
+		if (job.status == TEST_FAILED) {
+			fprintf(file, "    <failure message=\"%s\"/>\n", escape_xml(job.message).c_str());
+		}
+		else if (job.status == TEST_ERROR) {
+			fprintf(file, "    <error message=\"%s\"/>\n", escape_xml(job.message).c_str());
+		}
+		if (job.status != TEST_PASSED) {
+			fprintf(file, "    <system-out>%s</system-out>\n", escape_xml(job.output).c_str());
+		}
+		fprintf(file, "  </testcase>\n");
+	}
+	fprintf(file, "</testsuite>\n");
+	fclose(file);
+}
+
+void write_json(const char* filename, double total_time) {
+	FILE* file = fopen(filename, "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", filename);
+		exit(1);
+	}
+
+	int passed = 0;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		passed += jobs[i].status == TEST_PASSED;
+	}
+
+	fprintf(file, "{\n  \"tests\": %d,\n  \"passed\": %d,\n  \"failed\": %d,\n  \"time\": %.3f,\n  \"results\": [",
+		(int)jobs.size(), passed, (int)jobs.size() - passed, total_time);
+	for (size_t i = 0; i < jobs.size(); i++) {
+		const test_job& job = jobs[i];
+		const char* status = job.status == TEST_PASSED ? "pass" : job.status == TEST_FAILED ? "fail" : "error";
+		fprintf(file, "%s\n    {\"rom\": \"%s\", \"status\": \"%s\", \"message\": \"%s\", \"cycles\": %llu, \"time\": %.3f}",
+			i ? "," : "", escape_json(job.name).c_str(), status, escape_json(job.message).c_str(),
+			(unsigned long long)job.cycles, job.time);
+	}
+	fprintf(file, "\n  ]\n}\n");
+	fclose(file);
+}
+
+string escape_xml(const string& text) {
+	string escaped;
+	for (size_t i = 0; i < text.size(); i++) {
+		unsigned char c = text[i];
+		switch (c) {
+		case '&': escaped += "&amp;"; break;
+		case '<': escaped += "&lt;"; break;
+		case '>': escaped += "&gt;"; break;
+		case '"': escaped += "&quot;"; break;
+		default:
+			// Control characters other than tab and newline are not allowed in XML 1.0.
+			if (c >= 0x20 || c == '\t' || c == '\n') {
+				escaped += (char)c;
+			}
+			break;
+		}
+	}
+	return escaped;
+}
+
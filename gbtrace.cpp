@@ -0,0 +1,262 @@
+// Reads the execution traces emu writes with --trace or --trace-mapped (see
+// trace.h). Prints the records oldest first, optionally only some of them,
+// or compares two traces and shows where they first differ.
+//
+// Records are numbered from the first instruction of the run, so a trace
+// whose ring wrapped starts at some later number, and two traces are
+// compared over the numbers both of them still have.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "opcode_names.h"
+#include "symbols.h"
+#include "trace.h"
+
+#ifdef _WIN32
+#define fseeko _fseeki64
+#define ftello _ftelli64
+#endif
+
+using namespace std;
+
+const size_t TRACE_READ_RECORDS = 1 << 16;  // Records read from the file at once.
+
+// Reads the records of one trace file by number.
+struct trace_reader {
+	FILE* file;
+	const char* filename;
+	trace_header header;
+	uint64_t first;  // Number of the oldest record in the file.
+	uint64_t end;    // One past the newest.
+	vector<trace_record> buffer;
+	uint64_t buffer_slot;  // Ring slot of buffer[0].
+
+	void open(const char* name);  // Exits if the file is not a trace.
+	const trace_record& read(uint64_t number);
+};
+
+// Which records to print.
+struct trace_filter {
+	uint64_t last;
+	int pc_from;
+	int pc_to;
+	int bank;
+	int opcode;
+	bool matches(const trace_record& record) const;
+};
+
+bool symbols_loaded = false;
+
+void usage();
+int print_trace(const char* filename, const trace_filter& filter);
+int diff_traces(const char* first, const char* second, uint64_t context);
+void print_record(uint64_t number, const trace_record& record, const char* prefix);
+string record_difference(const trace_record& a, const trace_record& b);  // Names of the fields that differ.
+
+int main(int argc, char** argv) {
+	vector<const char*> files;
+	bool diff = false;
+	uint64_t context = 16;
+	trace_filter filter;
+	filter.last = 0;
+	filter.pc_from = 0;
+	filter.pc_to = 0xFFFF;
+	filter.bank = -1;
+	filter.opcode = -1;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--diff")) {
+			diff = true;
+		}
+		else if (!strcmp(argv[i], "--context") && i + 1 < argc) {
+			context = strtoull(argv[++i], NULL, 10);
+		}
+		else if (!strcmp(argv[i], "--last") && i + 1 < argc) {
+			filter.last = strtoull(argv[++i], NULL, 10);
+		}
+		else if (!strcmp(argv[i], "--pc") && i + 1 < argc) {
+			const char* range = argv[++i];
+			filter.pc_from = (int)strtol(range, NULL, 16);
+			const char* dash = strchr(range, '-');
+			filter.pc_to = dash ? (int)strtol(dash + 1, NULL, 16) : filter.pc_from;
+		}
+		else if (!strcmp(argv[i], "--bank") && i + 1 < argc) {
+			filter.bank = (int)strtol(argv[++i], NULL, 16);
+		}
+		else if (!strcmp(argv[i], "--opcode") && i + 1 < argc) {
+			filter.opcode = (int)strtol(argv[++i], NULL, 16);
+		}
+		else if (!strcmp(argv[i], "--symbols") && i + 1 < argc) {
+			if (!load_symbols(argv[++i])) {
+				fprintf(stderr, "Could not read %s\n", argv[i]);
+				exit(1);
+			}
+			symbols_loaded = true;
+		}
+		else if (argv[i][0] == '-') {
+			usage();
+		}
+		else {
+			files.push_back(argv[i]);
+		}
+	}
+
+	if (diff && files.size() == 2) {
+		return diff_traces(files[0], files[1], context);
+	}
+	if (diff || files.size() != 1) {
+		usage();
+	}
+	return print_trace(files[0], filter);
+}
+
+void usage() {
+	printf("Usage: gbtrace [options] trace\n"
+		"       gbtrace --diff [--context N] trace trace\n"
+		"  --last N          Only the newest N records.\n"
+		"  --pc ADDR[-ADDR]  Only records with the PC in this range, in hex.\n"
+		"  --bank N          Only records in this ROM bank, in hex (ff for the boot rom).\n"
+		"  --opcode XX       Only records of this opcode, in hex.\n"
+		"  --symbols FILE    Name PCs with the symbols in this RGBDS .sym file.\n"
+		"  --diff            Show where two traces first differ.\n"
+		"  --context N       Records to show before the difference (default: 16).\n");
+	exit(1);
+}
+
+int print_trace(const char* filename, const trace_filter& filter) {
+	trace_reader trace;
+	trace.open(filename);
+
+	uint64_t start = trace.first;
+	if (filter.last && trace.end - start > filter.last) {
+		start = trace.end - filter.last;
+	}
+	for (uint64_t number = start; number < trace.end; number++) {
+		const trace_record& record = trace.read(number);
+		if (filter.matches(record)) {
+			print_record(number, record, "");
+		}
+	}
+	return 0;
+}
+
+int diff_traces(const char* first, const char* second, uint64_t context) {
+	trace_reader a;
+	trace_reader b;
+	a.open(first);
+	b.open(second);
+
+	uint64_t start = a.first > b.first ? a.first : b.first;
+	uint64_t end = a.end < b.end ? a.end : b.end;
+	if (start >= end) {
+		printf("No records in common: %s has %llu-%llu, %s has %llu-%llu\n",
+			first, (unsigned long long)a.first, (unsigned long long)a.end - 1, second, (unsigned long long)b.first, (unsigned long long)b.end - 1);
+		return 1;
+	}
+
+	for (uint64_t number = start; number < end; number++) {
+		trace_record record_a = a.read(number);
+		trace_record record_b = b.read(number);
+		if (memcmp(&record_a, &record_b, sizeof(trace_record)) == 0) {
+			continue;
+		}
+
+		uint64_t from = number - start > context ? number - context : start;
+		for (uint64_t before = from; before < number; before++) {
+			print_record(before, a.read(before), "  ");
+		}
+		print_record(number, record_a, "< ");
+		print_record(number, record_b, "> ");
+		printf("First difference at record %llu: %s\n", (unsigned long long)number, record_difference(record_a, record_b).c_str());
+		return 2;
+	}
+
+	printf("Records %llu-%llu are the same", (unsigned long long)start, (unsigned long long)end - 1);
+	if (a.end != b.end) {
+		printf(", %s has %llu more", a.end > b.end ? first : second, (unsigned long long)(a.end > b.end ? a.end - b.end : b.end - a.end));
+	}
+	printf("\n");
+	return a.end == b.end ? 0 : 2;
+}
+
+void print_record(uint64_t number, const trace_record& record, const char* prefix) {
+	printf("%s%10llu  %02x:%04x  %-14s  A:%02x F:%c%c%c%c B:%02x C:%02x D:%02x E:%02x H:%02x L:%02x SP:%04x  +%u",
+		prefix, (unsigned long long)number, record.bank, record.pc, instruction_name(record.opcode, false),
+		record.a, record.f & 0x80 ? 'Z' : '-', record.f & 0x40 ? 'N' : '-', record.f & 0x20 ? 'H' : '-', record.f & 0x10 ? 'C' : '-',
+		record.b, record.c, record.d, record.e, record.h, record.l, record.sp, record.cycles);
+	if (symbols_loaded) {
+		printf("  %s", symbol_name(record.bank == 0xFF ? -1 : record.bank, record.pc).c_str());
+	}
+	printf("\n");
+}
+
+string record_difference(const trace_record& a, const trace_record& b) {
+	string fields;
+	const char* names[] = { "pc", "bank", "opcode", "a", "f", "b", "c", "d", "e", "h", "l", "sp", "cycles" };
+	int values_a[] = { a.pc, a.bank, a.opcode, a.a, a.f, a.b, a.c, a.d, a.e, a.h, a.l, a.sp, a.cycles };
+	int values_b[] = { b.pc, b.bank, b.opcode, b.a, b.f, b.b, b.c, b.d, b.e, b.h, b.l, b.sp, b.cycles };
+	for (int i = 0; i < 13; i++) {
+		if (values_a[i] != values_b[i]) {
+			fields += fields.empty() ? names[i] : string(" ") + names[i];
+		}
+	}
+	return fields;
+}
+
+void trace_reader::open(const char* name) {
+	filename = name;
+	file = fopen(name, "rb");
+	if (file == NULL) {
+		fprintf(stderr, "Could not read %s\n", name);
+		exit(1);
+	}
+	if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) ||
+		header.record_size != sizeof(trace_record) || header.capacity == 0 || (header.capacity & (header.capacity - 1))) {
+		fprintf(stderr, "%s is not a trace\n", name);
+		exit(1);
+	}
+
+	// Traces written from memory only hold the records that were written.
+	fseeko(file, 0, SEEK_END);
+	uint64_t stored = ((uint64_t)ftello(file) - sizeof(trace_header)) / sizeof(trace_record);
+	uint64_t kept = header.written < header.capacity ? header.written : header.capacity;
+	if (stored < kept) {
+		fprintf(stderr, "%s is cut short, %llu of %llu records\n", name, (unsigned long long)stored, (unsigned long long)kept);
+		exit(1);
+	}
+	first = header.written - kept;
+	end = header.written;
+	buffer_slot = 0;
+}
+
+const trace_record& trace_reader::read(uint64_t number) {
+	uint64_t slot = number & (header.capacity - 1);
+	if (slot < buffer_slot || slot >= buffer_slot + buffer.size()) {
+		uint64_t count = header.capacity - slot;
+		if (count > TRACE_READ_RECORDS) {
+			count = TRACE_READ_RECORDS;
+		}
+		if (count > header.written - slot) {
+			count = header.written - slot;
+		}
+		buffer.resize((size_t)count);
+		buffer_slot = slot;
+		fseeko(file, sizeof(trace_header) + slot * sizeof(trace_record), SEEK_SET);
+		if (fread(buffer.data(), sizeof(trace_record), buffer.size(), file) != buffer.size()) {
+			fprintf(stderr, "Could not read %s\n", filename);
+			exit(1);
+		}
+	}
+	return buffer[(size_t)(slot - buffer_slot)];
+}
+
+bool trace_filter::matches(const trace_record& record) const {
+	return record.pc >= pc_from && record.pc <= pc_to &&
+		(bank < 0 || record.bank == bank) &&
+		(opcode < 0 || record.opcode == opcode);
+}
@@ -0,0 +1,114 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hotspot.h"
+#include "symbols.h"
+
+using namespace std;
+
+const size_t PC_PROFILE_TOP_ADDRESSES = 200;  // Addresses listed in the report.
+
+uint64_t pc_sample_deadline = UINT64_MAX;
+int pc_sample_interval = 0;
+unordered_map<uint32_t, uint64_t> pc_samples;  // Keyed by bank << 16 | pc.
+
+string pc_profile_file;
+pc_profile_format pc_profile_type = PC_PROFILE_REPORT;
+
+// Totals of pc_samples under some name, most samples first.
+vector<pair<string, uint64_t>> total_samples(bool by_symbol);
+string folded_stack(const string& symbol);  // "Global;Global.local" for local labels.
+
+void start_pc_sampling(int interval, const char* filename, pc_profile_format format) {
+	pc_sample_interval = interval;
+	pc_sample_deadline = interval;
+	pc_profile_file = filename;
+	pc_profile_type = format;
+}
+
+void sample_pc(uint16_t pc, int bank) {
+	if (bank >= 0) {
+		pc_samples[bank << 16 | pc]++;
+	}
+	pc_sample_deadline += pc_sample_interval;
+}
+
+void write_pc_profile() {
+	bool to_stdout = pc_profile_file == "-";
+	FILE* file = to_stdout ? stdout : fopen(pc_profile_file.c_str(), "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", pc_profile_file.c_str());
+		return;
+	}
+
+	uint64_t total = 0;
+	for (unordered_map<uint32_t, uint64_t>::const_iterator i = pc_samples.begin(); i != pc_samples.end(); ++i) {
+		total += i->second;
+	}
+
+	if (pc_profile_type == PC_PROFILE_FOLDED) {
+		vector<pair<string, uint64_t>> symbols = total_samples(true);
+		for (size_t i = 0; i < symbols.size(); i++) {
+			fprintf(file, "%s %llu\n", folded_stack(symbols[i].first).c_str(), (unsigned long long)symbols[i].second);
+		}
+	}
+	else {
+		fprintf(file, "PC samples: %llu, one every %d cycles\n", (unsigned long long)total, pc_sample_interval);
+
+		vector<pair<string, uint64_t>> symbols = total_samples(true);
+		fprintf(file, "By symbol:\n  samples       %%  symbol\n");
+		for (size_t i = 0; i < symbols.size(); i++) {
+			fprintf(file, "  %7llu  %6.2f  %s\n", (unsigned long long)symbols[i].second,
+				total ? 100.0 * symbols[i].second / total : 0.0, symbols[i].first.c_str());
+		}
+
+		vector<pair<string, uint64_t>> addresses = total_samples(false);
+		addresses.resize(min(addresses.size(), PC_PROFILE_TOP_ADDRESSES));
+		fprintf(file, "By address:\n  samples       %%  address  symbol\n");
+		for (size_t i = 0; i < addresses.size(); i++) {
+			fprintf(file, "  %7llu  %6.2f  %s\n", (unsigned long long)addresses[i].second,
+				total ? 100.0 * addresses[i].second / total : 0.0, addresses[i].first.c_str());
+		}
+	}
+
+	if (to_stdout) {
+		fflush(stdout);
+	}
+	else {
+		fclose(file);
+	}
+}
+
+vector<pair<string, uint64_t>> total_samples(bool by_symbol) {
+	map<string, uint64_t> totals;
+	for (unordered_map<uint32_t, uint64_t>::const_iterator i = pc_samples.begin(); i != pc_samples.end(); ++i) {
+		int bank = i->first >> 16;
+		uint16_t pc = i->first & 0xFFFF;
+		string name = symbol_name(bank, pc, !by_symbol);
+		if (!by_symbol) {
+			char address[16];
+			snprintf(address, sizeof(address), "%02x:%04x", bank, pc);
+			name = name == address ? name : address + ("  " + name);
+		}
+		totals[name] += i->second;
+	}
+
+	vector<pair<string, uint64_t>> sorted(totals.begin(), totals.end());
+	stable_sort(sorted.begin(), sorted.end(),
+		[](const pair<string, uint64_t>& a, const pair<string, uint64_t>& b) { return a.second > b.second; });
+	return sorted;
+}
+
+string folded_stack(const string& symbol) {
+	size_t dot = symbol.find('.');
+	if (dot == string::npos || dot == 0) {
+		return symbol;
+	}
+	return symbol.substr(0, dot) + ";" + symbol;
+}
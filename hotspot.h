@@ -0,0 +1,31 @@
+// Sampling PC profiler. Every pc_sample_interval emulated cycles the core
+// hands the program counter and its ROM bank to sample_pc(), which counts
+// them per bank:address. While it is off the core only pays for comparing
+// the cycle count with pc_sample_deadline, and while it is on the cost
+// grows with the sampling rate.
+//
+// The report names addresses with the symbols from load_symbols() (see
+// symbols.h), totalled per symbol and per address. The folded output has
+// one "stack count" line per symbol, local labels under their global one,
+// for flamegraph.pl and the tools that read its input.
+#pragma once
+
+#include <stdint.h>
+
+enum pc_profile_format {
+	PC_PROFILE_REPORT,  // Sorted tables, most samples first.
+	PC_PROFILE_FOLDED,
+};
+
+extern uint64_t pc_sample_deadline;  // Emulated cycle of the next sample, UINT64_MAX when off.
+
+// Starts sampling every interval cycles. filename is where
+// write_pc_profile() writes to, "-" for stdout. Call before starting the
+// core.
+void start_pc_sampling(int interval, const char* filename, pc_profile_format format);
+
+// Counts one sample. Run by the core at pc_sample_deadline. Samples in the
+// boot rom (bank -1) are left out.
+void sample_pc(uint16_t pc, int bank);
+
+void write_pc_profile();  // Writes the samples out. Call after the core has stopped.
@@ -0,0 +1,41 @@
+// Triple buffered frame mailbox.
+// One thread draws into the back buffer and publishes it, another picks up the
+// newest published frame. The third buffer sits between them and is swapped
+// with a single atomic exchange, so neither side ever waits on the other.
+// Frames the consumer did not get to in time are simply overwritten.
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+template <typename Frame>
+class FrameMailbox {
+public:
+	FrameMailbox() : back(0), front(1), middle(2) {}
+
+	// Producer side.
+	Frame& back_buffer() { return buffers[back]; }
+	void publish() {
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+
+	// Consumer side. Returns true if a new frame was moved to the front.
+	bool acquire() {
+		if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+			return false;
+		}
+		front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+		return true;
+	}
+	const Frame& front_buffer() const { return buffers[front]; }
+
+private:
+	static const uint8_t INDEX = 0x3;
+	static const uint8_t FRESH = 0x4;  // Set when middle holds an unread frame.
+
+	Frame buffers[3];
+	uint8_t back;                  // Only touched by the producer.
+	uint8_t front;                 // Only touched by the consumer.
+	std::atomic<uint8_t> middle;   // Index of the spare buffer plus FRESH bit.
+};
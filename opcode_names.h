@@ -0,0 +1,8 @@
+// Mnemonics for the opcodes, indexed like the core's instructions[] and
+// CB_instructions[] tables. Kept apart from the core so tools that only name
+// opcodes, like gbtrace, don't have to link it.
+#pragma once
+
+#include <stdint.h>
+
+const char* instruction_name(uint8_t opcode, bool cb);  // "UNKNOWN" for the opcodes that don't exist.
@@ -0,0 +1,28 @@
+// PPU state shared by the mode machine in gameboy.cpp and the pixel FIFO in
+// ppu_fifo.cpp.
+#pragma once
+
+#include <stdint.h>
+
+#include "gameboy.h"
+
+extern uint8_t memory[65536];
+extern long int cycle_count;             // Cycles run in the current frame.
+extern uint64_t emulated_cycles;         // Cycles run before the current frame.
+extern int last_cycles;                  // Cycles taken by the last instruction.
+extern int scanline_count;               // Cycles left in the current line.
+extern uint8_t ppu_mode;                 // 0 HBLANK, 1 VBLANK, 2 OAM search, 3 transfer.
+extern bool lcd_enabled;                 // Mirrors bit 7 of 0xFF40.
+extern const uint32_t* bg_palette;       // Decoded 0xFF47.
+extern const uint32_t* obj_palette[2];   // Decoded 0xFF48, 0xFF49.
+extern uint32_t (*frame_buffer)[SCREEN_WIDTH];  // Mailbox back buffer, in renderer.cpp.
+
+void set_ppu_mode(uint8_t mode, int deadline);  // Sets the mode bits of 0xFF41 and the next deadline.
+void check_coincidence();     // Compares LY with LYC and sets bit 2 of 0xFF41.
+void update_stat_interupt();  // Requests a STAT interupt on a rising edge of the enabled sources.
+void set_interupt(uint8_t interupt);            // Allows for interupts to be set.
+uint8_t test_bit(uint8_t bit, uint8_t number);  // Doesn't set flags.
+
+// Pixel FIFO PPU, see ppu_fifo.cpp.
+void fifo_step();  // Runs the PPU for the cycles of the last instruction, dot by dot during transfer.
+void fifo_start_frame();  // Starts the window over from its first line.
@@ -0,0 +1,329 @@
+// Cycle accurate PPU. Models the mode 3 background fetcher and pixel FIFO
+// dot by dot, so mode 3 takes as long as it does on hardware (longer with
+// fine scrolling, the window and sprites) and register writes in the middle
+// of a line take effect from the next pixel. Only built into the emulation
+// loop when PPU_FIFO is defined, see the ppu policy in gameboy.cpp.
+#include <stdint.h>
+
+#include "gameboy.h"
+#include "ppu.h"
+#include "renderer.h"
+
+// A sprite picked during OAM search for the current line.
+struct line_sprite {
+	uint8_t y;
+	uint8_t x;
+	uint8_t tile;
+	uint8_t attributes;
+	bool fetched;
+};
+
+// A pixel waiting in the sprite FIFO.
+struct sprite_pixel {
+	uint8_t color;       // 0 is transparent.
+	uint8_t palette;     // 0 OBP0, 1 OBP1.
+	bool behind_bg;      // Only shows over background colour 0.
+};
+
+// Sprites for this line in OAM order.
+line_sprite line_sprites[10];
+int line_sprite_count;
+
+// Background fetcher. The DMG only pushes a fetched tile once the FIFO is
+// empty, so it never holds more than 8 pixels.
+uint8_t bg_fifo[8];
+int bg_fifo_count;
+int fetch_step;      // Dots into the current tile fetch, negative while idle.
+int fetch_x;         // Tile column being fetched, relative to SCX or the window.
+uint8_t fetch_tile;  // Tile number read in step 1.
+uint8_t fetch_low;   // Low bit plane read in step 3.
+uint8_t fetch_high;  // High bit plane read in step 5.
+bool fetch_window;   // Fetching from the window rather than the background.
+
+// Sprite FIFO, indexed by screen x & 7 so a sprite can be merged in place.
+sprite_pixel sprite_fifo[8];
+int sprite_stall;           // Dots left until the sprite being fetched is merged.
+int stalled_sprite;         // Index into line_sprites of that sprite.
+
+int lx;                     // Next screen x to output.
+int discard;                // Background pixels still to drop for SCX & 7.
+int window_line;            // Internal window line counter.
+bool window_on_line;        // The window was drawn on this line.
+bool window_y_triggered;    // LY has matched WY this frame.
+
+void start_transfer();      // Picks the sprites for the line and resets the fetcher.
+void fifo_dot();            // Runs one dot of mode 3.
+void fetcher_dot();         // Advances the background fetcher by one dot.
+void merge_sprite(int sprite);  // Fetches a sprite's row and mixes it into the sprite FIFO.
+void fifo_end_line();       // Moves on to the next line, VBLANK or the next frame.
+
+void fifo_step() {
+	if (!lcd_enabled) {
+		return;
+	}
+
+	int cycles = last_cycles;
+	while (cycles > 0) {
+		// Transfer runs dot by dot until 160 pixels are out.
+		if (ppu_mode == 3) {
+			fifo_dot();
+			scanline_count--;
+			cycles--;
+			if (lx == SCREEN_WIDTH) {
+				set_ppu_mode(0, 0);
+				update_stat_interupt();
+			}
+			continue;
+		}
+
+		// Nothing to do per dot in the other modes, skip to the next change.
+		int boundary = ppu_mode == 2 ? 376 : 0;
+		int run = scanline_count - boundary < cycles ? scanline_count - boundary : cycles;
+		scanline_count -= run;
+		cycles -= run;
+		if (scanline_count == boundary) {
+			if (ppu_mode == 2) {
+				start_transfer();
+			}
+			else {
+				fifo_end_line();
+			}
+			update_stat_interupt();
+		}
+	}
+}
+
+void start_transfer() {
+	uint8_t currentline = memory[0xFF44];
+	int height = test_bit(2, memory[0xFF40]) ? 16 : 8;
+
+	// OAM search, the first 10 sprites covering this line.
+	line_sprite_count = 0;
+	for (int sprite = 0; sprite < 40 && line_sprite_count < 10; sprite++) {
+		const uint8_t* oam = memory + 0xFE00 + sprite * 4;
+		int top = oam[0] - 16;
+		if (currentline >= top && currentline < top + height) {
+			line_sprite& s = line_sprites[line_sprite_count++];
+			s.y = oam[0];
+			s.x = oam[1];
+			s.tile = oam[2];
+			s.attributes = oam[3];
+			s.fetched = false;
+		}
+	}
+
+	if (currentline == memory[0xFF4A]) {
+		window_y_triggered = true;
+	}
+
+	// Five idle dots stand in for the first tile fetch, which hardware throws
+	// away. With SCX & 7 == 0 and no window or sprites mode 3 is 172 dots.
+	bg_fifo_count = 0;
+	fetch_step = -5;
+	fetch_x = 0;
+	fetch_window = false;
+	for (int i = 0; i < 8; i++) {
+		sprite_fifo[i].color = 0;
+	}
+	sprite_stall = 0;
+	lx = 0;
+	discard = memory[0xFF43] & 7;
+	window_on_line = false;
+
+	set_ppu_mode(3, 0);
+}
+
+void fifo_dot() {
+	uint8_t lcdc = memory[0xFF40];
+
+	// A sprite fetch holds up the pixel output. The background fetcher may
+	// finish the tile it is on, then waits for the last 6 dots.
+	if (sprite_stall > 0) {
+		if (sprite_stall > 6) {
+			fetcher_dot();
+		}
+		if (--sprite_stall == 0) {
+			merge_sprite(stalled_sprite);
+		}
+		return;
+	}
+
+	// Window starts at WX - 7, the fetcher restarts from its first column.
+	if (!fetch_window && test_bit(5, lcdc) && window_y_triggered && lx >= memory[0xFF4B] - 7) {
+		fetch_window = true;
+		window_on_line = true;
+		bg_fifo_count = 0;
+		fetch_step = 0;
+		fetch_x = 0;
+		discard = 0;
+	}
+
+	// Sprites starting at this pixel, one fetch at a time. Costs 6 dots plus
+	// however long the background fetcher needs to finish its current tile.
+	if (test_bit(1, lcdc) && discard == 0) {
+		for (int sprite = 0; sprite < line_sprite_count; sprite++) {
+			line_sprite& s = line_sprites[sprite];
+			int start = s.x < 8 ? 0 : s.x - 8;
+			if (!s.fetched && s.x > 0 && s.x < 168 && start == lx) {
+				s.fetched = true;
+				stalled_sprite = sprite;
+				sprite_stall = 6 + (fetch_step < 5 ? 5 - (fetch_step < 0 ? 0 : fetch_step) : 0);
+				return;
+			}
+		}
+	}
+
+	// Shift a pixel out before the fetcher runs, so it can push again in the
+	// same dot the FIFO runs empty.
+	if (bg_fifo_count > 0) {
+		uint8_t color = bg_fifo[8 - bg_fifo_count--];
+		if (discard > 0) {
+			discard--;
+		}
+		else {
+			if (!test_bit(0, lcdc)) {
+				color = 0;
+			}
+			uint32_t pixel = bg_palette[color];
+
+			sprite_pixel& sp = sprite_fifo[lx & 7];
+			if (sp.color && test_bit(1, lcdc) && !(sp.behind_bg && color)) {
+				pixel = obj_palette[sp.palette][sp.color];
+			}
+			sp.color = 0;
+
+			frame_buffer[memory[0xFF44]][lx++] = pixel;
+		}
+	}
+
+	fetcher_dot();
+}
+
+void fetcher_dot() {
+	uint8_t lcdc = memory[0xFF40];
+	uint8_t currentline = memory[0xFF44];
+
+	// Registers are read at the step that uses them, so mid-line writes show.
+	int row;
+	if (fetch_window) {
+		row = window_line & 7;
+	}
+	else {
+		row = (uint8_t)(currentline + memory[0xFF42]) & 7;
+	}
+
+	switch (fetch_step) {
+	// Tile number
+	case 1: {
+		int location = test_bit(fetch_window ? 6 : 3, lcdc) ? 0x9C00 : 0x9800;
+		int tileRow, tileColumn;
+		if (fetch_window) {
+			tileRow = window_line / 8 * 32;
+			tileColumn = fetch_x & 31;
+		}
+		else {
+			tileRow = (uint8_t)(currentline + memory[0xFF42]) / 8 * 32;
+			tileColumn = ((memory[0xFF43] >> 3) + fetch_x) & 31;
+		}
+		fetch_tile = memory[location + tileRow + tileColumn];
+		break;
+	}
+
+	// Tile data, low and high bit planes.
+	case 3:
+	case 5: {
+		int address;
+		if (test_bit(4, lcdc)) {
+			address = 0x8000 + fetch_tile * 16;
+		}
+		else {
+			address = 0x9000 + (signed char)fetch_tile * 16;
+		}
+		if (fetch_step == 3) {
+			fetch_low = memory[address + 2 * row];
+		}
+		else {
+			fetch_high = memory[address + 2 * row + 1];
+		}
+		break;
+	}
+
+	// Push once the FIFO is empty, otherwise wait.
+	case 6:
+		if (bg_fifo_count > 0) {
+			return;
+		}
+		for (int x = 0; x < 8; x++) {
+			int bitIndex = 1 << (7 - x);
+			bg_fifo[x] = (fetch_low & bitIndex ? 1 : 0) + (fetch_high & bitIndex ? 2 : 0);
+		}
+		bg_fifo_count = 8;
+		fetch_x++;
+		fetch_step = 0;
+		return;
+	}
+	fetch_step++;
+}
+
+void merge_sprite(int sprite) {
+	const line_sprite& s = line_sprites[sprite];
+	bool tall = test_bit(2, memory[0xFF40]);
+	int height = tall ? 16 : 8;
+
+	int row = memory[0xFF44] - (s.y - 16);
+	if (test_bit(6, s.attributes)) {
+		row = height - 1 - row;
+	}
+	int tile = tall ? s.tile & 0xFE : s.tile;
+	int address = 0x8000 + tile * 16 + 2 * row;
+	uint8_t low = memory[address];
+	uint8_t high = memory[address + 1];
+
+	// Earlier sprites keep their pixels, only transparent slots are filled.
+	for (int i = 0; i < 8; i++) {
+		int x = s.x - 8 + i;
+		if (x < lx) {
+			continue;
+		}
+		int bit = test_bit(5, s.attributes) ? i : 7 - i;
+		uint8_t color = ((low >> bit) & 1) | (((high >> bit) & 1) << 1);
+		sprite_pixel& sp = sprite_fifo[x & 7];
+		if (color && !sp.color) {
+			sp.color = color;
+			sp.palette = test_bit(4, s.attributes);
+			sp.behind_bg = test_bit(7, s.attributes);
+		}
+	}
+}
+
+void fifo_start_frame() {
+	window_line = 0;
+	window_on_line = false;
+	window_y_triggered = false;
+}
+
+void fifo_end_line() {
+	if (window_on_line) {
+		window_line++;
+	}
+
+	scanline_count += 456;
+	memory[0xFF44]++;
+	// Check if all lines are finished and if so do a VBLANK.
+	if (memory[0xFF44] == 144) {
+		set_ppu_mode(1, 0);
+		fifo_start_frame();
+
+		publish_frame(emulated_cycles + cycle_count);
+		set_interupt(0);
+	}
+	// Reset scanline once it reaches the end.
+	else if (memory[0xFF44] > 153) {
+		memory[0xFF44] = 0;
+		set_ppu_mode(2, 376);
+	}
+	else if (memory[0xFF44] < 144) {
+		set_ppu_mode(2, 376);
+	}
+	check_coincidence();
+}
@@ -0,0 +1,147 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gameboy.h"
+#include "profile.h"
+
+using namespace std;
+
+const size_t PROFILE_TOP_PAIRS = 64;     // Pairs listed in the table.
+const size_t PROFILE_JSON_PAIRS = 1024;  // Pairs written to JSON.
+
+uint64_t opcode_counts[PROFILE_OPCODES];
+uint64_t opcode_cycles[PROFILE_OPCODES];
+uint64_t opcode_pairs[PROFILE_OPCODES][PROFILE_OPCODES];
+int previous_opcode = 0;
+std::atomic<bool> profile_dump_requested(false);
+
+string profile_file = "-";
+profile_format profile_type = PROFILE_TABLE;
+
+// One entry of opcode_pairs.
+struct opcode_pair {
+	uint64_t count;
+	int first;
+	int second;
+};
+
+const char* opcode_name(int opcode);  // Mnemonic, from instructions[] or CB_instructions[].
+string opcode_label(int opcode);      // "3e" for base opcodes, "cb 7c" for CB ones.
+vector<opcode_pair> top_pairs(size_t count);  // The most common pairs, most common first.
+void write_profile_table(FILE* file);
+void write_profile_json(FILE* file);
+
+void set_profile_output(const char* filename, profile_format format) {
+	profile_file = filename;
+	profile_type = format;
+}
+
+void write_opcode_profile() {
+	bool to_stdout = profile_file == "-";
+	FILE* file = to_stdout ? stdout : fopen(profile_file.c_str(), "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", profile_file.c_str());
+		return;
+	}
+
+	if (profile_type == PROFILE_JSON) {
+		write_profile_json(file);
+	}
+	else {
+		write_profile_table(file);
+	}
+
+	if (to_stdout) {
+		fflush(stdout);
+	}
+	else {
+		fclose(file);
+	}
+}
+
+const char* opcode_name(int opcode) { return instruction_name(opcode & 0xFF, opcode >= 0x100); }
+
+string opcode_label(int opcode) {
+	char label[8];
+	snprintf(label, sizeof(label), opcode >= 0x100 ? "cb %02x" : "%02x", opcode & 0xFF);
+	return label;
+}
+
+vector<opcode_pair> top_pairs(size_t count) {
+	vector<opcode_pair> pairs;
+	for (int first = 0; first < PROFILE_OPCODES; first++) {
+		for (int second = 0; second < PROFILE_OPCODES; second++) {
+			if (opcode_pairs[first][second]) {
+				pairs.push_back(opcode_pair{ opcode_pairs[first][second], first, second });
+			}
+		}
+	}
+
+	count = min(count, pairs.size());
+	partial_sort(pairs.begin(), pairs.begin() + count, pairs.end(),
+		[](const opcode_pair& a, const opcode_pair& b) { return a.count > b.count; });
+	pairs.resize(count);
+	return pairs;
+}
+
+void write_profile_table(FILE* file) {
+	uint64_t total_count = 0;
+	uint64_t total_cycles = 0;
+	vector<int> opcodes;
+	for (int opcode = 0; opcode < PROFILE_OPCODES; opcode++) {
+		if (opcode_counts[opcode]) {
+			opcodes.push_back(opcode);
+			total_count += opcode_counts[opcode];
+			total_cycles += opcode_cycles[opcode];
+		}
+	}
+	sort(opcodes.begin(), opcodes.end(), [](int a, int b) { return opcode_counts[a] > opcode_counts[b]; });
+
+	fprintf(file, "Opcodes: %llu instructions, %llu cycles\n", (unsigned long long)total_count,
+		(unsigned long long)total_cycles);
+	fprintf(file, "  opcode  name             count        %%        cycles       %%\n");
+	for (size_t i = 0; i < opcodes.size(); i++) {
+		int opcode = opcodes[i];
+		fprintf(file, "  %-6s  %-15s %12llu  %6.2f  %12llu  %6.2f\n", opcode_label(opcode).c_str(), opcode_name(opcode),
+			(unsigned long long)opcode_counts[opcode], total_count ? 100.0 * opcode_counts[opcode] / total_count : 0.0,
+			(unsigned long long)opcode_cycles[opcode], total_cycles ? 100.0 * opcode_cycles[opcode] / total_cycles : 0.0);
+	}
+
+	vector<opcode_pair> pairs = top_pairs(PROFILE_TOP_PAIRS);
+	fprintf(file, "Most common pairs:\n");
+	fprintf(file, "  first   name             second  name                    count        %%\n");
+	for (size_t i = 0; i < pairs.size(); i++) {
+		const opcode_pair& pair = pairs[i];
+		fprintf(file, "  %-6s  %-15s  %-6s  %-15s  %12llu  %6.2f\n", opcode_label(pair.first).c_str(),
+			opcode_name(pair.first), opcode_label(pair.second).c_str(), opcode_name(pair.second),
+			(unsigned long long)pair.count, total_count ? 100.0 * pair.count / total_count : 0.0);
+	}
+}
+
+void write_profile_json(FILE* file) {
+	fprintf(file, "{\n  \"opcodes\": [");
+	bool first_entry = true;
+	for (int opcode = 0; opcode < PROFILE_OPCODES; opcode++) {
+		if (!opcode_counts[opcode]) {
+			continue;
+		}
+		fprintf(file, "%s\n    {\"opcode\": \"%s\", \"name\": \"%s\", \"count\": %llu, \"cycles\": %llu}",
+			first_entry ? "" : ",", opcode_label(opcode).c_str(), opcode_name(opcode),
+			(unsigned long long)opcode_counts[opcode], (unsigned long long)opcode_cycles[opcode]);
+		first_entry = false;
+	}
+	fprintf(file, "\n  ],\n  \"pairs\": [");
+
+	vector<opcode_pair> pairs = top_pairs(PROFILE_JSON_PAIRS);
+	for (size_t i = 0; i < pairs.size(); i++) {
+		const opcode_pair& pair = pairs[i];
+		fprintf(file, "%s\n    {\"first\": \"%s\", \"second\": \"%s\", \"count\": %llu}", i ? "," : "",
+			opcode_label(pair.first).c_str(), opcode_label(pair.second).c_str(), (unsigned long long)pair.count);
+	}
+	fprintf(file, "\n  ]\n}\n");
+}
@@ -0,0 +1,42 @@
+// Opcode profiler. Building with OPCODE_PROFILE (see CMakeLists.txt) has
+// cpu_cycle() count every instruction it runs, the cycles it charged for it
+// and which instruction ran just before it. Without OPCODE_PROFILE there is
+// no profiling code in cpu_cycle() at all.
+//
+// Opcodes are numbered 0x000-0x0FF for the base set and 0x100-0x1FF for the
+// CB set. Cycles are the ones the core counts, so every CB opcode shows the
+// cycles of the 0xCB entry in Cycles[].
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+const int PROFILE_OPCODES = 0x200;
+
+enum profile_format {
+	PROFILE_TABLE,  // Opcodes and the most common pairs, sorted by count.
+	PROFILE_JSON,
+};
+
+extern uint64_t opcode_counts[PROFILE_OPCODES];
+extern uint64_t opcode_cycles[PROFILE_OPCODES];
+extern uint64_t opcode_pairs[PROFILE_OPCODES][PROFILE_OPCODES];  // [previous][current]
+extern int previous_opcode;
+extern std::atomic<bool> profile_dump_requested;  // Set by the front end to have the core write the profile after the frame.
+
+// Called by cpu_cycle() after each instruction.
+inline void profile_opcode(int opcode, int cycles) {
+	opcode_counts[opcode]++;
+	opcode_cycles[opcode] += cycles;
+	opcode_pairs[previous_opcode][opcode]++;
+	previous_opcode = opcode;
+}
+
+// Where write_opcode_profile() writes to, a file name or "-" for stdout.
+// Call before starting the core.
+void set_profile_output(const char* filename, profile_format format);
+
+// Writes the counts so far. Run by the core on request and by the front end
+// once the core has stopped.
+void write_opcode_profile();
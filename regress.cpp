@@ -0,0 +1,181 @@
+// Golden image regression runner. Runs emu headless on every rom in a list,
+// several at a time, and reports the first frame whose hash differs from the
+// golden file. The core keeps all of its state in globals, so each rom gets
+// its own emu process.
+//
+// Each line of the list is "<rom> <golden file> <frames> [movie]". Paths with
+// spaces go in double quotes and lines starting with # are skipped. With
+// --audio the audio hashes are checked too, against "<golden file>.audio".
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "runner.h"
+
+using namespace std;
+
+// One rom to run.
+struct regression_job {
+	string rom;
+	string golden;
+	string frames;
+	string movie;
+
+	bool passed;
+	string result;  // Divergence report, or the last line emu printed.
+};
+
+// Options
+string emu_path;             // Defaults to emu next to this program.
+string bootrom_path;         // Passed on to emu when set.
+bool update_golden = false;  // Write the golden files instead of comparing.
+bool check_audio = false;    // Also compare the audio hashes.
+unsigned int thread_count = 0;
+
+vector<regression_job> jobs;
+
+void usage();                                     // Prints the command line options and exits.
+void read_job_list(const char* filename);         // Fills jobs from the list file.
+void run_job(regression_job& job);                // Runs emu on one rom and records the result.
+
+int main(int argc, char** argv) {
+	const char* list_file = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+			thread_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--update")) {
+			update_golden = true;
+		}
+		else if (!strcmp(argv[i], "--audio")) {
+			check_audio = true;
+		}
+		else if (!strcmp(argv[i], "--emu") && i + 1 < argc) {
+			emu_path = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--bootrom") && i + 1 < argc) {
+			bootrom_path = argv[++i];
+		}
+		else if (argv[i][0] == '-' || list_file) {
+			usage();
+		}
+		else {
+			list_file = argv[i];
+		}
+	}
+	if (!list_file) {
+		usage();
+	}
+
+	if (emu_path.empty()) {
+		emu_path = sibling_program(argv[0], "emu");
+	}
+	if (thread_count == 0) {
+		thread_count = default_thread_count();
+	}
+
+	read_job_list(list_file);
+
+	run_jobs(jobs.size(), thread_count, [](size_t i) { run_job(jobs[i]); });
+
+	int failed = 0;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		if (jobs[i].passed) {
+			printf("PASS %s\n", jobs[i].rom.c_str());
+		}
+		else {
+			printf("FAIL %s: %s\n", jobs[i].rom.c_str(), jobs[i].result.c_str());
+			failed++;
+		}
+	}
+	printf("%d passed, %d failed\n", (int)jobs.size() - failed, failed);
+
+	return failed ? 1 : 0;
+}
+
+void usage() {
+	printf("Usage: regress [options] list\n"
+		"  -j N              Run N roms at once (default: one per core).\n"
+		"  --update          Write the golden files instead of comparing against them.\n"
+		"  --audio           Check the audio hashes too, kept in <golden file>.audio.\n"
+		"  --emu PATH        Emulator to run (default: emu next to regress).\n"
+		"  --bootrom FILE    Boot rom passed on to the emulator.\n");
+	exit(1);
+}
+
+void read_job_list(const char* filename) {
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		cerr << "Invalid List File!" << endl;
+		exit(1);
+	}
+
+	string line;
+	while (getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		vector<string> fields = split_fields(line);
+		if (fields.empty()) {
+			continue;
+		}
+		if (fields.size() < 3 || fields.size() > 4 || fields[2].find_first_not_of("0123456789") != string::npos) {
+			cerr << "Invalid List Line: " << line << endl;
+			exit(1);
+		}
+
+		regression_job job;
+		job.rom = fields[0];
+		job.golden = fields[1];
+		job.frames = fields[2];
+		if (fields.size() == 4) {
+			job.movie = fields[3];
+		}
+		job.passed = false;
+		jobs.push_back(job);
+	}
+}
+
+void run_job(regression_job& job) {
+	string command = quote(emu_path) + " --headless --frames " + job.frames;
+	command += (update_golden ? " --hashes " : " --golden ") + quote(job.golden);
+	if (check_audio) {
+		command += (update_golden ? " --audio-hashes " : " --audio-golden ") + quote(job.golden + ".audio");
+	}
+	if (!job.movie.empty()) {
+		command += " --movie " + quote(job.movie);
+	}
+	if (!bootrom_path.empty()) {
+		command += " --bootrom " + quote(bootrom_path);
+	}
+	command += " " + quote(job.rom);
+
+	FILE* output = start_command(command);
+	if (output == NULL) {
+		job.result = "could not start " + emu_path;
+		return;
+	}
+
+	// Keep the divergence report if there is one, otherwise the last line.
+	char line[512];
+	bool diverged = false;
+	while (fgets(line, sizeof(line), output)) {
+		line[strcspn(line, "\r\n")] = 0;
+		if (!strncmp(line, "First diverging", 15)) {
+			job.result = line;
+			diverged = true;
+		}
+		else if (!diverged && line[0]) {
+			job.result = line;
+		}
+	}
+
+	job.passed = finish_command(output) == 0 && !diverged;
+}
@@ -0,0 +1,499 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "capture.h"
+#include "gameboy.h"
+#include "hash.h"
+#include "renderer.h"
+#include "timeline.h"
+
+using namespace std;
+
+// Frame hand off to the front end. frame_buffer always points at the
+// mailbox back buffer and moves on every time a frame is published.
+FrameMailbox<frame> frame_mailbox;
+uint32_t (*frame_buffer)[SCREEN_WIDTH] = frame_mailbox.back_buffer().pixels;
+bool frame_hashes_enabled = false;
+vector<uint64_t> frame_hashes;
+uint64_t stop_frame_hash = 0;
+std::atomic<bool> stop_frame_seen(false);
+
+// The renderer's own copy of VRAM. Frames are drawn from this, and comparing
+// it with the VRAM of the next frame tells which tiles and map entries need
+// decoding or redrawing.
+uint8_t renderer_vram[0x2000];
+uint32_t renderer_vram_version = 0;
+
+// Tiles
+uint8_t Tile_Map[384][8][8];
+bool tile_dirty[384];      // Tile data changed since the tile was last decoded.
+bool tiles_dirty = false;  // Set if any entry of tile_dirty is.
+
+// Background cache. Both 32x32 tile maps pre-rendered as colour indices, so
+// a line is two wrapped copies at SCX/SCY instead of a tile lookup per pixel.
+// Only the parts touched by VRAM writes are redrawn.
+bool bg_cache_enabled = true;
+uint8_t bg_cache[2][256][256];
+bool bg_cache_unsigned = false;           // Tile addressing mode (LCDC bit 4) the cache was drawn with.
+bool bg_cache_valid[2];                   // Cleared to redraw a whole map (tile addressing mode changed).
+bool bg_cache_dirty[2] = { true, true };  // Something below changed since the map was last redrawn.
+bool bg_entry_dirty[2][1024];             // Map entries written.
+bool bg_tile_changed[2][384];             // Tiles decoded again.
+
+// Sprite pattern cache. The four flipped versions of each sprite tile as
+// [flip][y][x], flip being bit 0 for X and bit 1 for Y. Built the first time
+// a tile is drawn as a sprite and dropped whenever the tile is decoded again.
+uint8_t sprite_patterns[256][4][8][8];
+bool sprite_pattern_valid[256];
+
+// Worker thread. job is only written by the core while job_pending is clear
+// and only read by the worker while it is set.
+struct render_job {
+	line_registers lines[SCREEN_HEIGHT];
+	uint8_t vram[0x2000];
+	uint8_t oam[0xA0];
+	int first_line;
+	uint64_t time;
+} job;
+bool render_thread_enabled = true;
+bool job_pending = false;
+bool renderer_running = false;
+mutex render_mutex;
+condition_variable job_ready;
+condition_variable job_done;
+thread render_thread;
+
+void renderer_loop();  // Worker thread body.
+void render_frame(const uint8_t* vram, const uint8_t* oam, const line_registers* lines, int first_line, uint64_t time);
+void sync_vram(const uint8_t* vram, uint32_t version);  // Brings renderer_vram up to date and marks what changed.
+uint8_t read_vram(int location) { return renderer_vram[location - 0x8000]; }
+uint8_t test_bit(uint8_t bit, uint8_t number);  // From gameboy.cpp.
+
+// Drawing functions.
+void load_tiles();           // Decodes tiles changed since the last call into Tiles[][x][y].
+void render_tile_map_line(uint8_t currentline, const line_registers& regs);         // Arranges tiles according to tilemap onto one line.
+void render_cached_tile_map_line(uint8_t currentline, const line_registers& regs);  // Same as above but copies from bg_cache.
+void update_bg_cache(int map);       // Redraws the dirty parts of one tile map into bg_cache.
+void invalidate_bg_cache();          // Forces both maps to be redrawn in full.
+void render_all_tiles(const uint32_t* palette);  // Test function to render all the tiles onto screen.
+void render_sprites(const uint8_t* oam, const line_registers* lines);  // Renders the sprites over the whole frame.
+const uint8_t* sprite_pattern(uint8_t tile, int flip);  // Returns the 8x8 colours of a sprite tile flipped as asked.
+
+void start_renderer() {
+	if (!render_thread_enabled) {
+		return;
+	}
+	renderer_running = true;
+	render_thread = thread(renderer_loop);
+}
+
+void stop_renderer() {
+	if (!render_thread.joinable()) {
+		return;
+	}
+	{
+		lock_guard<mutex> lock(render_mutex);
+		renderer_running = false;
+	}
+	job_ready.notify_one();
+	render_thread.join();
+}
+
+void wait_for_renderer() {
+	TIMELINE_SCOPE("wait_for_renderer");
+	unique_lock<mutex> lock(render_mutex);
+	job_done.wait(lock, [] { return !job_pending; });
+}
+
+void submit_frame(const uint8_t* vram, const uint8_t* oam, const line_registers* lines, int first_line, uint64_t time) {
+	if (!renderer_running) {
+		render_frame(vram, oam, lines, first_line, time);
+		return;
+	}
+
+	wait_for_renderer();
+	memcpy(job.vram, vram, sizeof(job.vram));
+	memcpy(job.oam, oam, sizeof(job.oam));
+	memcpy(job.lines, lines, sizeof(job.lines));
+	job.first_line = first_line;
+	job.time = time;
+	{
+		lock_guard<mutex> lock(render_mutex);
+		job_pending = true;
+	}
+	job_ready.notify_one();
+}
+
+void renderer_loop() {
+	TIMELINE_THREAD("renderer");
+	unique_lock<mutex> lock(render_mutex);
+	while (true) {
+		job_ready.wait(lock, [] { return job_pending || !renderer_running; });
+		if (!job_pending) {
+			break;
+		}
+
+		lock.unlock();
+		render_frame(job.vram, job.oam, job.lines, job.first_line, job.time);
+		lock.lock();
+
+		job_pending = false;
+		job_done.notify_all();
+	}
+}
+
+// Renders the rest of the frame, adds the sprites and publishes it.
+void render_frame(const uint8_t* vram, const uint8_t* oam, const line_registers* lines, int first_line, uint64_t time) {
+	TIMELINE_SCOPE("render_frame");
+	render_lines(vram, lines, first_line, SCREEN_HEIGHT);
+	render_sprites(oam, lines);
+	publish_frame(time);
+}
+
+// Hashes each line and then the whole of the finished frame, hands it over
+// and starts drawing into the next one.
+void publish_frame(uint64_t time) {
+	TIMELINE_SCOPE("publish_frame");
+	frame& finished = frame_mailbox.back_buffer();
+	finished.time = time;
+	for (int y = 0; y < SCREEN_HEIGHT; y++) {
+		finished.line_hash[y] = xxhash64(finished.pixels[y], sizeof(finished.pixels[y]));
+	}
+	finished.hash = xxhash64(finished.line_hash, sizeof(finished.line_hash));
+	if (frame_hashes_enabled) {
+		frame_hashes.push_back(finished.hash);
+	}
+	if (stop_frame_hash && finished.hash == stop_frame_hash) {
+		stop_frame_seen = true;
+		emulation_running = false;
+	}
+	if (capture_enabled) {
+		capture_frame(finished);
+	}
+
+	frame_mailbox.publish();
+	frame_buffer = frame_mailbox.back_buffer().pixels;
+}
+
+void render_lines(const uint8_t* vram, const line_registers* lines, int first, int last) {
+	if (first >= last) {
+		return;
+	}
+	TIMELINE_SCOPE("render_lines");
+
+	// All lines given at once share the same VRAM.
+	sync_vram(vram, lines[first].vram_version);
+	load_tiles();
+
+	for (int line = first; line < last; line++) {
+		if (bg_cache_enabled) {
+			render_cached_tile_map_line(line, lines[line]);
+		}
+		else {
+			render_tile_map_line(line, lines[line]);
+		}
+	}
+}
+
+void sync_vram(const uint8_t* vram, uint32_t version) {
+	if (version == renderer_vram_version) {
+		return;
+	}
+	renderer_vram_version = version;
+
+	// Tile data, 16 bytes per tile.
+	for (int s = 0; s < 384; s++) {
+		if (memcmp(renderer_vram + 16 * s, vram + 16 * s, 16)) {
+			tile_dirty[s] = true;
+			tiles_dirty = true;
+		}
+	}
+
+	// Tile maps
+	for (int map = 0; map < 2; map++) {
+		int offset = 0x1800 + 0x400 * map;
+		for (int entry = 0; entry < 1024; entry++) {
+			if (renderer_vram[offset + entry] != vram[offset + entry]) {
+				bg_entry_dirty[map][entry] = true;
+				bg_cache_dirty[map] = true;
+			}
+		}
+	}
+
+	memcpy(renderer_vram, vram, sizeof(renderer_vram));
+}
+
+void load_tiles() {
+	if (!tiles_dirty) {
+		return;
+	}
+	tiles_dirty = false;
+
+	int location = 0x8000;
+
+	for (int s = 0; s < 384; s++) {
+		if (!tile_dirty[s]) {
+			continue;
+		}
+		tile_dirty[s] = false;
+
+		int Rel_y = 0;
+		while (Rel_y < 8) {
+			int Rel_x = 0;
+			while (Rel_x < 8) {
+				int bitIndex = 1 << (7 - Rel_x);
+				Tile_Map[s][Rel_x][Rel_y] = (read_vram(location + 2 * Rel_y + 16 * s) & bitIndex ? 1 : 0) + ((read_vram(location + 1 + 2 * Rel_y + 16 * s) & bitIndex) ? 2 : 0);
+				Rel_x++;
+			}
+			Rel_y++;
+		}
+
+		// Anything in the caches drawn with this tile is now stale.
+		for (int map = 0; map < 2; map++) {
+			bg_tile_changed[map][s] = true;
+			bg_cache_dirty[map] = true;
+		}
+		if (s < 256) {
+			sprite_pattern_valid[s] = false;
+		}
+	}
+}
+
+
+void render_all_tiles(const uint32_t* palette) {
+	for (int i = 0; i < 360; i++) {
+		for (int x = 0; x < 8; x++) {
+			for (int y = 0; y < 8; y++) {
+				frame_buffer[(y + i * 8 / 160 * 8)][(i * 8 % 160) + x] = palette[Tile_Map[i][x][y]];
+			}
+		}
+	}
+}
+
+
+void render_tile_map_line(uint8_t currentline, const line_registers& regs) {
+	uint8_t ScrollY = regs.scroll_y;
+	uint8_t ScrollX = regs.scroll_x;
+	uint8_t WindowY = regs.window_y;
+	uint8_t WindowX = regs.window_x;
+	const uint32_t* bg_palette = regs.bg_palette;
+
+	// Which tile data?
+	bool unsig = true;
+	if (!test_bit(4, regs.lcdc)) {
+		unsig = false;
+	}
+
+	// Are we using windowing?
+	bool windowingEnabled = false;
+	if (test_bit(5, regs.lcdc)) {
+		windowingEnabled = true;
+	}
+
+	// Check which tilemap to render.
+	int location;
+	if (test_bit(3, regs.lcdc)) {
+		location = 0x9C00;
+	}
+	else {
+		location = 0x9800;
+	}
+
+	int window_location;
+	if (test_bit(6, regs.lcdc)) {
+		window_location = 0x9C00;
+	}
+	else {
+		window_location = 0x9800;
+	}
+
+	int yPos = currentline + ScrollY;
+	int tileRow = (yPos / 8) % 32 * 32;
+
+	int pixel = 0;
+	// Draw non-windowed component
+	for (; pixel < 160; pixel++) {
+		if (windowingEnabled && pixel >= WindowX && currentline >= WindowY) {
+			break;
+		}
+		int xPos = pixel + ScrollX;
+		int tileColumn = (xPos / 8) % 32;
+
+		int tileNum;
+		if (unsig) {
+			tileNum = read_vram(location + tileRow + tileColumn);
+		}
+		else {
+			tileNum = (signed char)read_vram(location + tileRow + tileColumn) + 0x100;
+		}
+
+		frame_buffer[currentline][pixel] = bg_palette[Tile_Map[tileNum][xPos % 8][yPos % 8]];
+	}
+
+	// Draw windowed component
+	yPos = currentline - WindowY;
+	tileRow = yPos / 8 * 32;
+	for (; pixel < 160; pixel++) {
+		int xPos = pixel - WindowX;
+		int tileColumn = (xPos / 8) % 32;
+		int tileNum;
+		if (unsig) {
+			tileNum = read_vram(window_location + tileRow + tileColumn);
+		}
+		else {
+			tileNum = (signed char)read_vram(window_location + tileRow + tileColumn) + 0x100;
+		}
+
+		frame_buffer[currentline][pixel] = bg_palette[Tile_Map[tileNum][xPos % 8][yPos % 8]];
+	}
+}
+
+
+void render_cached_tile_map_line(uint8_t currentline, const line_registers& regs) {
+	uint8_t lcdc = regs.lcdc;
+	uint8_t ScrollY = regs.scroll_y;
+	uint8_t ScrollX = regs.scroll_x;
+	uint8_t WindowY = regs.window_y;
+	uint8_t WindowX = regs.window_x;
+	const uint32_t* bg_palette = regs.bg_palette;
+
+	// The cache has to be redrawn if the tile addressing mode changed.
+	if (test_bit(4, lcdc) != bg_cache_unsigned) {
+		bg_cache_unsigned = test_bit(4, lcdc);
+		invalidate_bg_cache();
+	}
+
+	int map = test_bit(3, lcdc);
+	int window_map = test_bit(6, lcdc);
+
+	// First pixel covered by the window.
+	int window_start = SCREEN_WIDTH;
+	if (test_bit(5, lcdc) && currentline >= WindowY && WindowX < SCREEN_WIDTH) {
+		window_start = WindowX;
+	}
+
+	uint32_t* line = frame_buffer[currentline];
+
+	// Background, in two spans if it wraps around the right edge of the map.
+	if (window_start > 0) {
+		if (bg_cache_dirty[map]) {
+			update_bg_cache(map);
+		}
+		const uint8_t* row = bg_cache[map][(uint8_t)(currentline + ScrollY)];
+		int first_span = 256 - ScrollX < window_start ? 256 - ScrollX : window_start;
+		int pixel = 0;
+		for (; pixel < first_span; pixel++) {
+			line[pixel] = bg_palette[row[ScrollX + pixel]];
+		}
+		for (; pixel < window_start; pixel++) {
+			line[pixel] = bg_palette[row[pixel - first_span]];
+		}
+	}
+
+	// Window, which never wraps.
+	if (window_start < SCREEN_WIDTH) {
+		if (bg_cache_dirty[window_map]) {
+			update_bg_cache(window_map);
+		}
+		const uint8_t* row = bg_cache[window_map][currentline - WindowY];
+		for (int pixel = window_start; pixel < SCREEN_WIDTH; pixel++) {
+			line[pixel] = bg_palette[row[pixel - WindowX]];
+		}
+	}
+}
+
+
+void update_bg_cache(int map) {
+	int location = map ? 0x9C00 : 0x9800;
+	bool unsig = bg_cache_unsigned;
+
+	for (int entry = 0; entry < 1024; entry++) {
+		int tileNum;
+		if (unsig) {
+			tileNum = read_vram(location + entry);
+		}
+		else {
+			tileNum = (signed char)read_vram(location + entry) + 0x100;
+		}
+
+		if (bg_cache_valid[map] && !bg_entry_dirty[map][entry] && !bg_tile_changed[map][tileNum]) {
+			continue;
+		}
+
+		int tileRow = entry / 32 * 8;
+		int tileColumn = entry % 32 * 8;
+		for (int y = 0; y < 8; y++) {
+			for (int x = 0; x < 8; x++) {
+				bg_cache[map][tileRow + y][tileColumn + x] = Tile_Map[tileNum][x][y];
+			}
+		}
+	}
+
+	memset(bg_entry_dirty[map], 0, sizeof(bg_entry_dirty[map]));
+	memset(bg_tile_changed[map], 0, sizeof(bg_tile_changed[map]));
+	bg_cache_valid[map] = true;
+	bg_cache_dirty[map] = false;
+}
+
+
+void invalidate_bg_cache() {
+	for (int map = 0; map < 2; map++) {
+		bg_cache_valid[map] = false;
+		bg_cache_dirty[map] = true;
+	}
+}
+
+
+void render_sprites(const uint8_t* oam, const line_registers* lines) {
+	TIMELINE_SCOPE("render_sprites");
+	for (int sprite = 0; sprite < 40; sprite++) {
+		uint8_t index = sprite * 4;
+		uint8_t ypos = oam[index] - 16;
+		uint8_t xpos = oam[index + 1] - 8;
+		uint8_t location = oam[index + 2];
+		uint8_t attributes = oam[index + 3];
+
+		int flip = test_bit(5, attributes) | test_bit(6, attributes) << 1;
+		int palette = test_bit(4, attributes);
+
+		if (ypos == 0 || xpos == 0 || ypos >= 160 || xpos >= 168) {
+			continue;
+		}
+
+		const uint8_t* pattern = sprite_pattern(location, flip);
+		for (int y = 0; y < 8; y++) {
+			int currentline = (y + ypos) % SCREEN_HEIGHT;
+			uint32_t* line = frame_buffer[currentline];
+			const uint32_t* obj_palette = lines[currentline].obj_palette[palette];
+			const uint8_t* row = pattern + 8 * y;
+			for (int x = 0; x < 8; x++) {
+				if (row[x]) {
+					line[(xpos + x) % SCREEN_WIDTH] = obj_palette[row[x]];
+				}
+			}
+		}
+	}
+}
+
+
+const uint8_t* sprite_pattern(uint8_t tile, int flip) {
+	if (!sprite_pattern_valid[tile]) {
+		for (int y = 0; y < 8; y++) {
+			for (int x = 0; x < 8; x++) {
+				uint8_t color = Tile_Map[tile][x][y];
+				sprite_patterns[tile][0][y][x] = color;
+				sprite_patterns[tile][1][y][7 - x] = color;
+				sprite_patterns[tile][2][7 - y][x] = color;
+				sprite_patterns[tile][3][7 - y][7 - x] = color;
+			}
+		}
+		sprite_pattern_valid[tile] = true;
+	}
+	return &sprite_patterns[tile][flip][0][0];
+}
+
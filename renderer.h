@@ -0,0 +1,43 @@
+// Renderer. The core does not draw anything while a frame runs, it only logs
+// the registers that affect each visible line. At VBLANK the log, a copy of
+// VRAM and a copy of OAM are handed to a worker thread which draws the whole
+// frame while the core carries on with the next one.
+// Everything in renderer.cpp belongs to whichever thread is currently
+// drawing. The core calls wait_for_renderer() before it draws anything itself.
+#pragma once
+
+#include <stdint.h>
+
+#include "gameboy.h"
+
+// Registers that affect drawing, captured at the end of each visible line.
+struct line_registers {
+	uint8_t lcdc;                    // 0xFF40
+	uint8_t scroll_y;                // 0xFF42
+	uint8_t scroll_x;                // 0xFF43
+	uint8_t window_y;                // 0xFF4A
+	uint8_t window_x;                // 0xFF4B
+	const uint32_t* bg_palette;      // Decoded 0xFF47
+	const uint32_t* obj_palette[2];  // Decoded 0xFF48, 0xFF49
+	uint32_t vram_version;           // Bumped by the core on every VRAM change.
+};
+
+extern bool render_thread_enabled;  // Draw frames on the worker thread. Set before start_renderer().
+
+void start_renderer();     // Starts the worker thread.
+void stop_renderer();      // Finishes any queued frame and stops the worker thread.
+void wait_for_renderer();  // Blocks until the worker has finished the frame it was given.
+
+// Draws lines [first, last) straight away from the given VRAM. Only call
+// after wait_for_renderer().
+void render_lines(const uint8_t* vram, const line_registers* lines, int first, int last);
+
+// Hands a finished frame to the renderer. Lines before first_line were
+// already drawn with render_lines(). vram and oam are copied, so the core can
+// keep running as soon as this returns. time is the emulated cycle of the
+// VBLANK, passed on to the published frame.
+void submit_frame(const uint8_t* vram, const uint8_t* oam, const line_registers* lines, int first_line, uint64_t time);
+
+// Fills in the hashes and time of frame_buffer, publishes it to frame_mailbox
+// and points frame_buffer at the next back buffer.
+void publish_frame(uint64_t time);
@@ -0,0 +1,130 @@
+#include <stdio.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "runner.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+using namespace std;
+
+vector<string> split_fields(const string& line) {
+	vector<string> fields;
+	size_t i = 0;
+	while (i < line.size()) {
+		if (line[i] == ' ' || line[i] == '\t' || line[i] == '\r') {
+			i++;
+			continue;
+		}
+
+		string field;
+		if (line[i] == '"') {
+			size_t end = line.find('"', i + 1);
+			if (end == string::npos) {
+				end = line.size();
+			}
+			field = line.substr(i + 1, end - i - 1);
+			i = end + 1;
+		}
+		else {
+			size_t end = line.find_first_of(" \t\r", i);
+			if (end == string::npos) {
+				end = line.size();
+			}
+			field = line.substr(i, end - i);
+			i = end;
+		}
+		fields.push_back(field);
+	}
+	return fields;
+}
+
+string quote(const string& text) {
+#ifdef _WIN32
+	return "\"" + text + "\"";
+#else
+	// Nothing is special inside single quotes, so only a single quote itself
+	// has to be closed, escaped and opened again.
+	string quoted = "'";
+	for (size_t i = 0; i < text.size(); i++) {
+		if (text[i] == '\'') {
+			quoted += "'\\''";
+		}
+		else {
+			quoted += text[i];
+		}
+	}
+	return quoted + "'";
+#endif
+}
+
+string escape_json(const string& text) {
+	string escaped;
+	for (size_t i = 0; i < text.size(); i++) {
+		unsigned char c = text[i];
+		if (c == '"' || c == '\\') {
+			escaped += '\\';
+			escaped += (char)c;
+		}
+		else if (c < 0x20) {
+			char code[8];
+			snprintf(code, sizeof(code), "\\u%04x", c);
+			escaped += code;
+		}
+		else {
+			escaped += (char)c;
+		}
+	}
+	return escaped;
+}
+
+string sibling_program(const char* self, const char* name) {
+	string path = self;
+	size_t slash = path.find_last_of("/\\");
+	return (slash == string::npos ? string() : path.substr(0, slash + 1)) + name;
+}
+
+unsigned int default_thread_count() {
+	unsigned int count = thread::hardware_concurrency();
+	return count ? count : 4;
+}
+
+FILE* start_command(string command) {
+	command += " 2>&1";
+#ifdef _WIN32
+	// cmd /c drops the outer quotes, which would otherwise be the first and last
+	// of the ones in command.
+	command = quote(command);
+#endif
+	return popen(command.c_str(), "r");
+}
+
+int finish_command(FILE* output) {
+	return pclose(output);
+}
+
+void run_jobs(size_t count, unsigned int threads, const function<void(size_t)>& run) {
+	atomic<size_t> next_job(0);
+	vector<thread> workers;
+	for (unsigned int i = 0; i < threads && i < count; i++) {
+		workers.push_back(thread([&]() {
+			while (true) {
+				size_t job = next_job++;
+				if (job >= count) {
+					return;
+				}
+				run(job);
+			}
+		}));
+	}
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+}
@@ -0,0 +1,29 @@
+// Plumbing shared by the tools that run emu, or a copy of themselves, once
+// per job: regress, gbtest, sstest and gbbench. The core keeps all of its
+// state in globals, so anything that runs more than one rom does it in
+// child processes and reads what they print.
+#pragma once
+
+#include <stdio.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+std::vector<std::string> split_fields(const std::string& line);  // Splits a line on spaces, keeping quoted fields together.
+std::string quote(const std::string& text);                      // Quotes a command line argument for the shell popen runs.
+std::string escape_json(const std::string& text);                // Escapes text for use inside a JSON string.
+
+// The program called name in the same directory as self, which is argv[0].
+std::string sibling_program(const char* self, const char* name);
+
+unsigned int default_thread_count();  // One per core, 4 if that is not known.
+
+// Starts command with its output, stderr included, to be read from the
+// returned file. NULL if it could not be started.
+FILE* start_command(std::string command);
+
+int finish_command(FILE* output);  // Waits for a command to end. Returns its exit status, 0 on success.
+
+// Runs run(0) ... run(count - 1) on up to threads threads and waits for them.
+void run_jobs(size_t count, unsigned int threads, const std::function<void(size_t)>& run);
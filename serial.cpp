@@ -0,0 +1,133 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <iostream>
+
+#include "gameboy.h"
+#include "ppu.h"
+#include "serial.h"
+
+using namespace std;
+
+// A DMG shifts one bit every 512 cycles (8192 Hz) on its own clock.
+const int SERIAL_BYTE_CYCLES = 8 * 512;
+const size_t SERIAL_TAIL_SIZE = 256;  // Longest pass or fail string that can be matched.
+
+uint64_t serial_deadline = UINT64_MAX;
+string serial_output;
+uint8_t (*serial_peer)(uint8_t data) = NULL;
+
+vector<string> serial_pass_strings;
+vector<string> serial_fail_strings;
+serial_result_type serial_result = SERIAL_PENDING;
+string serial_result_text;
+
+serial_sink_type serial_sink = SERIAL_NONE;
+FILE* serial_file = NULL;
+string serial_tail;  // Last bytes sent, for matching the pass and fail strings.
+
+uint8_t exchange_byte(uint8_t data);  // Hands a sent byte to the sink and returns the one received.
+void check_serial_result();           // Looks for a pass or fail string at the end of serial_tail.
+
+void set_serial_sink(serial_sink_type type, const char* filename) {
+	serial_sink = type;
+	if (type == SERIAL_FILE) {
+		serial_file = fopen(filename, "wb");
+		if (serial_file == NULL) {
+			cerr << "Could not open serial output " << filename << endl;
+			exit(1);
+		}
+	}
+}
+
+void write_serial(uint8_t data, uint16_t location) {
+	if (location == 0xFF01) {
+		memory[0xFF01] = data;
+		return;
+	}
+
+	// Only bits 7 and 0 are there, the rest read back as 1.
+	memory[0xFF02] = data | 0x7E;
+	if (!(data & 0x80)) {
+		serial_deadline = UINT64_MAX;
+		return;
+	}
+
+	// With the external clock (bit 0 clear) nothing happens unless there is
+	// something on the other end to drive it, taken to run at the normal rate.
+	if ((data & 0x01) || serial_sink == SERIAL_PEER) {
+		serial_deadline = emulated_cycles + cycle_count + SERIAL_BYTE_CYCLES;
+	}
+	else {
+		serial_deadline = UINT64_MAX;
+	}
+}
+
+void serial_event() {
+	serial_deadline = UINT64_MAX;
+	memory[0xFF01] = exchange_byte(memory[0xFF01]);
+	memory[0xFF02] &= 0x7F;
+	set_interupt(3);
+}
+
+void stop_serial() {
+	if (serial_sink == SERIAL_STDOUT) {
+		fflush(stdout);
+	}
+	if (serial_file) {
+		fclose(serial_file);
+		serial_file = NULL;
+	}
+}
+
+uint8_t exchange_byte(uint8_t data) {
+	uint8_t received = 0xFF;  // Nothing connected, the line is pulled high.
+	switch (serial_sink) {
+	case SERIAL_NONE:
+		break;
+	case SERIAL_STDOUT:
+		putchar(data);
+		break;
+	case SERIAL_FILE:
+		fputc(data, serial_file);
+		break;
+	case SERIAL_BUFFER:
+		serial_output += (char)data;
+		break;
+	case SERIAL_PEER:
+		if (serial_peer) {
+			received = serial_peer(data);
+		}
+		break;
+	}
+
+	if (!serial_pass_strings.empty() || !serial_fail_strings.empty()) {
+		serial_tail += (char)data;
+		if (serial_tail.size() > SERIAL_TAIL_SIZE * 2) {
+			serial_tail.erase(0, serial_tail.size() - SERIAL_TAIL_SIZE);
+		}
+		check_serial_result();
+	}
+	return received;
+}
+
+void check_serial_result() {
+	if (serial_result != SERIAL_PENDING) {
+		return;
+	}
+
+	for (int pass = 0; pass < 2; pass++) {
+		const vector<string>& strings = pass ? serial_pass_strings : serial_fail_strings;
+		for (size_t i = 0; i < strings.size(); i++) {
+			const string& text = strings[i];
+			if (!text.empty() && serial_tail.size() >= text.size() &&
+				serial_tail.compare(serial_tail.size() - text.size(), text.size(), text) == 0) {
+				serial_result = pass ? SERIAL_PASSED : SERIAL_FAILED;
+				serial_result_text = text;
+				emulation_running = false;
+				return;
+			}
+		}
+	}
+}
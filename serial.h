@@ -0,0 +1,48 @@
+// Serial port (SB 0xFF01, SC 0xFF02). Writing SC with bit 7 set starts a
+// transfer, which is scheduled as a single event one byte time later rather
+// than shifted bit by bit. At that point the byte in SB goes to the serial
+// sink, the byte the sink answers with lands in SB, SC bit 7 is cleared and
+// the serial interupt is requested.
+//
+// Test roms (blargg's among them) print their results over serial, so the
+// bytes sent can also be watched for pass and fail strings, and the core
+// stops as soon as one turns up.
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// Where sent bytes go.
+enum serial_sink_type {
+	SERIAL_NONE,    // No cable, bytes are dropped.
+	SERIAL_STDOUT,  // Printed as they are sent.
+	SERIAL_FILE,    // Written to a file.
+	SERIAL_BUFFER,  // Appended to serial_output.
+	SERIAL_PEER,    // Exchanged with serial_peer.
+};
+
+extern uint64_t serial_deadline;     // Emulated cycle the transfer in progress finishes at, UINT64_MAX when idle.
+extern std::string serial_output;    // Bytes sent, with SERIAL_BUFFER.
+extern uint8_t (*serial_peer)(uint8_t data);  // Other end of the cable for SERIAL_PEER. Gets each byte sent and returns the byte received.
+
+// Pass and fail strings to watch the sent bytes for. Set before starting the
+// core. The first one seen stops the core and is left in serial_result.
+extern std::vector<std::string> serial_pass_strings;
+extern std::vector<std::string> serial_fail_strings;
+enum serial_result_type {
+	SERIAL_PENDING,  // Neither seen yet.
+	SERIAL_PASSED,
+	SERIAL_FAILED,
+};
+extern serial_result_type serial_result;
+extern std::string serial_result_text;  // The string that was seen.
+
+// Plugs a sink in. filename is only used by SERIAL_FILE. Call before starting
+// the core.
+void set_serial_sink(serial_sink_type type, const char* filename = NULL);
+
+void write_serial(uint8_t data, uint16_t location);  // Write to 0xFF01-0xFF02.
+void serial_event();  // Finishes the transfer in progress. Run by the core at serial_deadline.
+void stop_serial();   // Flushes and closes the sink. Call after the core has stopped.
@@ -0,0 +1,79 @@
+// Lock free single producer, single consumer ring buffer.
+// Size must be a power of two. One slot is never used so that a full queue
+// can be told apart from an empty one.
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+
+template <typename T, size_t Size>
+class SpscQueue {
+	static_assert((Size & (Size - 1)) == 0, "Size must be a power of two");
+
+public:
+	SpscQueue() : head(0), tail(0) {}
+
+	// Producer side. Returns false if the queue is full.
+	bool push(const T& item) {
+		size_t t = tail.load(std::memory_order_relaxed);
+		size_t next = (t + 1) & (Size - 1);
+		if (next == head.load(std::memory_order_acquire)) {
+			return false;
+		}
+		items[t] = item;
+		tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side. Returns false if the queue is empty.
+	bool pop(T& item) {
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = items[h];
+		head.store((h + 1) & (Size - 1), std::memory_order_release);
+		return true;
+	}
+
+	// Producer side. Pushes as many of items as fit with one release and
+	// returns how many did.
+	size_t push(const T* items, size_t count) {
+		size_t t = tail.load(std::memory_order_relaxed);
+		size_t space = (head.load(std::memory_order_acquire) - t - 1) & (Size - 1);
+		if (count > space) {
+			count = space;
+		}
+		for (size_t i = 0; i < count; i++) {
+			this->items[(t + i) & (Size - 1)] = items[i];
+		}
+		tail.store((t + count) & (Size - 1), std::memory_order_release);
+		return count;
+	}
+
+	// Consumer side. Pops up to count items with one release and returns how
+	// many it got.
+	size_t pop(T* items, size_t count) {
+		size_t h = head.load(std::memory_order_relaxed);
+		size_t available = (tail.load(std::memory_order_acquire) - h) & (Size - 1);
+		if (count > available) {
+			count = available;
+		}
+		for (size_t i = 0; i < count; i++) {
+			items[i] = this->items[(h + i) & (Size - 1)];
+		}
+		head.store((h + count) & (Size - 1), std::memory_order_release);
+		return count;
+	}
+
+	// Number of queued items. Only exact when called from either end.
+	size_t size() const {
+		return (tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire)) & (Size - 1);
+	}
+
+private:
+	T items[Size];
+	alignas(64) std::atomic<size_t> head;  // Next slot to read.
+	alignas(64) std::atomic<size_t> tail;  // Next slot to write.
+};
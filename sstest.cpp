@@ -0,0 +1,552 @@
+// Single step CPU test runner for the SingleStepTests (sm83) JSON vectors.
+// Each file holds the tests for one opcode ("00.json" ... "cb ff.json"),
+// every test an initial CPU and RAM state, the state after one instruction
+// and the bus cycles it takes. They run through cpu_cycle() with the core
+// built with FLAT_BUS, so memory is 64K of plain RAM.
+//
+// Files are read with a small pull parser, one test at a time, so even the
+// large ones never sit in memory whole. The core keeps its state in globals,
+// so for running files in parallel sstest starts a copy of itself per file.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gameboy.h"
+#include "runner.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// From gameboy.cpp.
+extern int last_cycles;
+
+// Machine state before or after a test.
+struct test_state {
+	cpu_state cpu;
+	vector<pair<uint16_t, uint8_t>> ram;  // Address, value.
+};
+
+struct test_case {
+	string name;
+	test_state initial;
+	test_state final;
+	int cycles;  // Machine cycles the instruction takes.
+};
+
+// Streaming JSON reader. Only what the test files use: objects, arrays,
+// strings without escapes other than \" and \\, unsigned numbers and null.
+struct json_reader {
+	FILE* file;
+	const char* filename;
+	char buffer[1 << 16];
+	size_t size;
+	size_t position;
+
+	int peek();
+	int get();
+	void skip_space();
+	bool consume(char c);  // Skips c if it is next.
+	void expect(char c);
+	string read_string();
+	long long read_number();
+	void skip_value();
+	void fail(const char* what);
+};
+
+// One file's results, from a child process.
+struct file_job {
+	string path;
+	string opcode;  // File name without .json, "00" or "cb 00".
+	int passed;
+	int failed;
+	int timing;     // Tests whose cycle count differs.
+	bool skipped;
+	vector<string> mismatches;
+	string error;
+};
+
+// Options
+bool check_timing = false;  // Count cycle mismatches as failures.
+int report_count = 3;       // Mismatches to print per opcode.
+unsigned int thread_count = 0;
+string self_path;
+
+vector<file_job> jobs;
+
+void usage();                                     // Prints the command line options and exits.
+void find_files(const char* path);                // Adds path, or every .json in it, to jobs.
+void run_job(file_job& job);                      // Runs a child on one file and reads its results.
+int run_file(const char* filename);               // Child process. Runs every test in filename and prints the results.
+void read_test(json_reader& in, test_case& test);
+void read_state(json_reader& in, test_state& state);
+bool run_test(const test_case& test, string& mismatch);  // Runs one test, describing any difference in mismatch.
+
+int main(int argc, char** argv) {
+	vector<const char*> paths;
+	const char* child_file = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+			thread_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--timing")) {
+			check_timing = true;
+		}
+		else if (!strcmp(argv[i], "--report") && i + 1 < argc) {
+			report_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--child") && i + 1 < argc) {
+			child_file = argv[++i];
+		}
+		else if (argv[i][0] == '-') {
+			usage();
+		}
+		else {
+			paths.push_back(argv[i]);
+		}
+	}
+	if (child_file) {
+		return run_file(child_file);
+	}
+	if (paths.empty()) {
+		usage();
+	}
+
+	self_path = argv[0];
+	if (thread_count == 0) {
+		thread_count = default_thread_count();
+	}
+
+	for (size_t i = 0; i < paths.size(); i++) {
+		find_files(paths[i]);
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	run_jobs(jobs.size(), thread_count, [](size_t i) { run_job(jobs[i]); });
+	double total_time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	// Only opcodes with something wrong are listed.
+	int opcodes_failed = 0;
+	int opcodes_skipped = 0;
+	long long passed = 0;
+	long long failed = 0;
+	long long timing = 0;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		const file_job& job = jobs[i];
+		passed += job.passed;
+		failed += job.failed;
+		timing += job.timing;
+		if (!job.error.empty()) {
+			printf("ERROR %s: %s\n", job.opcode.c_str(), job.error.c_str());
+			opcodes_failed++;
+		}
+		else if (job.skipped) {
+			opcodes_skipped++;
+		}
+		else if (job.failed) {
+			printf("FAIL  %s: %d of %d failed\n", job.opcode.c_str(), job.failed, job.passed + job.failed);
+			for (size_t j = 0; j < job.mismatches.size(); j++) {
+				printf("      %s\n", job.mismatches[j].c_str());
+			}
+			opcodes_failed++;
+		}
+	}
+	printf("%d opcodes passed, %d failed, %d skipped. %lld of %lld tests passed, %lld with different timing, in %.2fs\n",
+		(int)jobs.size() - opcodes_failed - opcodes_skipped, opcodes_failed, opcodes_skipped,
+		passed, passed + failed, timing, total_time);
+
+	return opcodes_failed ? 1 : 0;
+}
+
+void usage() {
+	printf("Usage: sstest [options] directory|file...\n"
+		"  -j N          Run N files at once (default: one per core).\n"
+		"  --timing      Fail tests whose cycle count differs, not just count them.\n"
+		"  --report N    Mismatches to show per opcode (default: 3).\n");
+	exit(1);
+}
+
+void find_files(const char* path) {
+	vector<file_job> found;
+	error_code error;
+	if (fs::is_directory(path, error)) {
+		for (fs::directory_iterator it(path, error), end; it != end; it.increment(error)) {
+			if (it->path().extension() == ".json") {
+				file_job job;
+				job.path = it->path().string();
+				found.push_back(job);
+			}
+		}
+	}
+	else {
+		file_job job;
+		job.path = path;
+		found.push_back(job);
+	}
+
+	for (size_t i = 0; i < found.size(); i++) {
+		found[i].opcode = fs::path(found[i].path).stem().string();
+		found[i].passed = 0;
+		found[i].failed = 0;
+		found[i].timing = 0;
+		found[i].skipped = false;
+	}
+	sort(found.begin(), found.end(), [](const file_job& a, const file_job& b) { return a.opcode < b.opcode; });
+	jobs.insert(jobs.end(), found.begin(), found.end());
+}
+
+void run_job(file_job& job) {
+	string command = quote(self_path) + " --child " + quote(job.path) + " --report " + to_string(report_count);
+	if (check_timing) {
+		command += " --timing";
+	}
+
+	FILE* output = start_command(command);
+	if (output == NULL) {
+		job.error = "could not start " + self_path;
+		return;
+	}
+
+	// "RESULT passed failed timing", "SKIPPED" or "MISMATCH text". Anything
+	// else is kept as the error in case there is no result.
+	char line[1024];
+	bool finished = false;
+	string last_line;
+	while (fgets(line, sizeof(line), output)) {
+		line[strcspn(line, "\r\n")] = 0;
+		if (sscanf(line, "RESULT %d %d %d", &job.passed, &job.failed, &job.timing) == 3) {
+			finished = true;
+		}
+		else if (!strcmp(line, "SKIPPED")) {
+			job.skipped = true;
+			finished = true;
+		}
+		else if (!strncmp(line, "MISMATCH ", 9)) {
+			job.mismatches.push_back(line + 9);
+		}
+		else if (line[0]) {
+			last_line = line;
+		}
+	}
+	if (finish_command(output) != 0 || !finished) {
+		job.error = last_line.empty() ? "child exited without a result" : last_line;
+	}
+}
+
+int run_file(const char* filename) {
+	// Opcodes the CPU does not have lock it up on hardware, and have no handler here.
+	string opcode = fs::path(filename).stem().string();
+	bool cb = opcode.size() == 5 && opcode.compare(0, 3, "cb ") == 0;
+	uint8_t value = (uint8_t)strtol(opcode.c_str() + (cb ? 3 : 0), NULL, 16);
+	if (!cb && !strcmp(instruction_name(value, false), "UNKNOWN")) {
+		printf("SKIPPED\n");
+		return 0;
+	}
+
+	json_reader in;
+	in.filename = filename;
+	in.file = fopen(filename, "rb");
+	if (in.file == NULL) {
+		printf("Could not read %s\n", filename);
+		return 1;
+	}
+	in.size = 0;
+	in.position = 0;
+
+	int passed = 0;
+	int failed = 0;
+	int timing = 0;
+	int reported = 0;
+	test_case test;
+	string mismatch;
+
+	in.expect('[');
+	while (!in.consume(']')) {
+		read_test(in, test);
+		in.consume(',');
+
+		bool same = run_test(test, mismatch);
+		bool same_timing = last_cycles == test.cycles * 4;
+		if (!same_timing) {
+			timing++;
+			if (check_timing) {
+				char cycles[64];
+				snprintf(cycles, sizeof(cycles), "%scycles %d != %d", mismatch.empty() ? "" : ", ",
+					last_cycles, test.cycles * 4);
+				mismatch += cycles;
+				same = false;
+			}
+		}
+
+		if (same) {
+			passed++;
+			continue;
+		}
+		failed++;
+		if (reported < report_count) {
+			printf("MISMATCH %s (%s): %s\n", test.name.c_str(), instruction_name(value, cb), mismatch.c_str());
+			reported++;
+		}
+	}
+	fclose(in.file);
+
+	printf("RESULT %d %d %d\n", passed, failed, timing);
+	return 0;
+}
+
+void read_test(json_reader& in, test_case& test) {
+	test.name.clear();
+	test.cycles = 0;
+
+	in.expect('{');
+	while (!in.consume('}')) {
+		string key = in.read_string();
+		in.expect(':');
+		if (key == "name") {
+			test.name = in.read_string();
+		}
+		else if (key == "initial") {
+			read_state(in, test.initial);
+		}
+		else if (key == "final") {
+			read_state(in, test.final);
+		}
+		else if (key == "cycles") {
+			// Each is [address, value, "r-m"] or null for an internal cycle,
+			// only the number of them is checked.
+			in.expect('[');
+			while (!in.consume(']')) {
+				in.skip_value();
+				in.consume(',');
+				test.cycles++;
+			}
+		}
+		else {
+			in.skip_value();
+		}
+		in.consume(',');
+	}
+}
+
+void read_state(json_reader& in, test_state& state) {
+	memset(&state.cpu, 0, sizeof(state.cpu));
+	state.ram.clear();
+
+	in.expect('{');
+	while (!in.consume('}')) {
+		string key = in.read_string();
+		in.expect(':');
+		if (key == "ram") {
+			in.expect('[');
+			while (!in.consume(']')) {
+				in.expect('[');
+				uint16_t address = (uint16_t)in.read_number();
+				in.expect(',');
+				uint8_t value = (uint8_t)in.read_number();
+				in.expect(']');
+				in.consume(',');
+				state.ram.push_back(make_pair(address, value));
+			}
+		}
+		else if (key.size() == 1 && strchr("afbcdehl", key[0])) {
+			uint8_t value = (uint8_t)in.read_number();
+			switch (key[0]) {
+			case 'a': state.cpu.a = value; break;
+			case 'f': state.cpu.f = value; break;
+			case 'b': state.cpu.b = value; break;
+			case 'c': state.cpu.c = value; break;
+			case 'd': state.cpu.d = value; break;
+			case 'e': state.cpu.e = value; break;
+			case 'h': state.cpu.h = value; break;
+			case 'l': state.cpu.l = value; break;
+			}
+		}
+		else if (key == "pc") {
+			state.cpu.pc = (uint16_t)in.read_number();
+		}
+		else if (key == "sp") {
+			state.cpu.sp = (uint16_t)in.read_number();
+		}
+		else if (key == "ime") {
+			state.cpu.ime = in.read_number() != 0;
+		}
+		else {
+			in.skip_value();  // ie, ei.
+		}
+		in.consume(',');
+	}
+}
+
+bool run_test(const test_case& test, string& mismatch) {
+	for (size_t i = 0; i < test.initial.ram.size(); i++) {
+		memory[test.initial.ram[i].first] = test.initial.ram[i].second;
+	}
+	set_cpu_state(test.initial.cpu);
+	bus_log_count = 0;
+
+	cpu_cycle();
+
+	mismatch.clear();
+	char text[64];
+	auto compare = [&](const char* name, int got, int expected, int digits) {
+		if (got != expected) {
+			snprintf(text, sizeof(text), "%s%s %0*x != %0*x", mismatch.empty() ? "" : ", ", name,
+				digits, got, digits, expected);
+			mismatch += text;
+		}
+	};
+
+	cpu_state got = get_cpu_state();
+	const cpu_state& expected = test.final.cpu;
+	compare("a", got.a, expected.a, 2);
+	compare("f", got.f, expected.f, 2);
+	compare("b", got.b, expected.b, 2);
+	compare("c", got.c, expected.c, 2);
+	compare("d", got.d, expected.d, 2);
+	compare("e", got.e, expected.e, 2);
+	compare("h", got.h, expected.h, 2);
+	compare("l", got.l, expected.l, 2);
+	compare("sp", got.sp, expected.sp, 4);
+	compare("pc", got.pc, expected.pc, 4);
+	compare("ime", got.ime, expected.ime, 1);
+	for (size_t i = 0; i < test.final.ram.size(); i++) {
+		uint16_t address = test.final.ram[i].first;
+		snprintf(text, sizeof(text), "[%04x]", address);
+		compare(string(text).c_str(), memory[address], test.final.ram[i].second, 2);
+	}
+
+	// Only touched memory is put back to 0, clearing all 64K every test would
+	// take longer than running it.
+	for (size_t i = 0; i < test.initial.ram.size(); i++) {
+		memory[test.initial.ram[i].first] = 0;
+	}
+	for (int i = 0; i < bus_log_count; i++) {
+		memory[bus_log[i].address] = 0;
+	}
+	return mismatch.empty();
+}
+
+int json_reader::peek() {
+	if (position == size) {
+		size = fread(buffer, 1, sizeof(buffer), file);
+		position = 0;
+		if (size == 0) {
+			return EOF;
+		}
+	}
+	return (unsigned char)buffer[position];
+}
+
+int json_reader::get() {
+	int c = peek();
+	if (c != EOF) {
+		position++;
+	}
+	return c;
+}
+
+void json_reader::skip_space() {
+	while (true) {
+		int c = peek();
+		if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+			return;
+		}
+		position++;
+	}
+}
+
+bool json_reader::consume(char c) {
+	skip_space();
+	if (peek() == c) {
+		position++;
+		return true;
+	}
+	return false;
+}
+
+void json_reader::expect(char c) {
+	if (!consume(c)) {
+		char what[16];
+		snprintf(what, sizeof(what), "'%c'", c);
+		fail(what);
+	}
+}
+
+string json_reader::read_string() {
+	expect('"');
+	string text;
+	while (true) {
+		int c = get();
+		if (c == EOF) {
+			fail("end of string");
+		}
+		if (c == '"') {
+			return text;
+		}
+		if (c == '\\') {
+			c = get();
+		}
+		text += (char)c;
+	}
+}
+
+long long json_reader::read_number() {
+	skip_space();
+	if (peek() < '0' || peek() > '9') {
+		fail("number");
+	}
+	long long value = 0;
+	while (peek() >= '0' && peek() <= '9') {
+		value = value * 10 + (get() - '0');
+	}
+	return value;
+}
+
+void json_reader::skip_value() {
+	skip_space();
+	int c = peek();
+	if (c == '"') {
+		read_string();
+	}
+	else if (c == '[' || c == '{') {
+		char close = c == '[' ? ']' : '}';
+		position++;
+		while (!consume(close)) {
+			if (c == '{') {
+				read_string();
+				expect(':');
+			}
+			skip_value();
+			consume(',');
+		}
+	}
+	else if (c == '-' || (c >= '0' && c <= '9')) {
+		get();
+		while ((peek() >= '0' && peek() <= '9') || peek() == '.' || peek() == 'e' || peek() == 'E' ||
+			peek() == '-' || peek() == '+') {
+			get();
+		}
+	}
+	else if (c >= 'a' && c <= 'z') {
+		// true, false, null.
+		while (peek() >= 'a' && peek() <= 'z') {
+			get();
+		}
+	}
+	else {
+		fail("value");
+	}
+}
+
+void json_reader::fail(const char* what) {
+	printf("Invalid test file %s: expected %s\n", filename, what);
+	exit(1);
+}
@@ -0,0 +1,68 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "symbols.h"
+
+using namespace std;
+
+map<uint32_t, string> symbols;  // Keyed by bank << 16 | address.
+
+int memory_region(uint16_t address);  // Index of the part of the memory map address is in.
+
+bool load_symbols(const char* filename) {
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	string line;
+	while (getline(file, line)) {
+		size_t comment = line.find(';');
+		if (comment != string::npos) {
+			line.erase(comment);
+		}
+
+		unsigned int bank;
+		unsigned int address;
+		char name[256];
+		if (sscanf(line.c_str(), "%x:%x %255s", &bank, &address, name) == 3 && address <= 0xFFFF) {
+			symbols[bank << 16 | address] = name;
+		}
+	}
+	return true;
+}
+
+string symbol_name(int bank, uint16_t address, bool with_offset) {
+	uint32_t key = bank << 16 | address;
+	map<uint32_t, string>::const_iterator symbol = symbols.upper_bound(key);
+	if (symbol != symbols.begin()) {
+		--symbol;
+		uint16_t symbol_address = symbol->first & 0xFFFF;
+		if ((int)(symbol->first >> 16) == bank && memory_region(symbol_address) == memory_region(address)) {
+			if (!with_offset || symbol_address == address) {
+				return symbol->second;
+			}
+			char offset[16];
+			snprintf(offset, sizeof(offset), "+0x%x", address - symbol_address);
+			return symbol->second + offset;
+		}
+	}
+
+	char label[16];
+	snprintf(label, sizeof(label), "%02x:%04x", bank, address);
+	return label;
+}
+
+int memory_region(uint16_t address) {
+	// ROM0, ROMX, VRAM, SRAM, WRAM, echo, OAM and IO, HRAM.
+	const uint16_t starts[] = { 0x4000, 0x8000, 0xA000, 0xC000, 0xE000, 0xFE00, 0xFF80 };
+	int region = 0;
+	while (region < 7 && address >= starts[region]) {
+		region++;
+	}
+	return region;
+}
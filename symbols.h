@@ -0,0 +1,16 @@
+// Symbols from RGBDS .sym files, for naming addresses in profiles. Each line
+// is "bank:address name" in hex, as rgblink -n writes them, and anything
+// after a ';' is a comment. Local labels keep their "Global.local" names.
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+// Adds the symbols in filename. Returns false if it could not be read.
+bool load_symbols(const char* filename);
+
+// The symbol at or before address in the same bank and memory region, as
+// "name+offset" (just "name" if it is exactly there, or without offset).
+// Addresses with no symbol before them come out as "bank:address".
+std::string symbol_name(int bank, uint16_t address, bool with_offset = true);
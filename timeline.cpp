@@ -0,0 +1,155 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "timeline.h"
+
+using namespace std;
+
+const size_t TIMELINE_EVENTS = 1 << 20;  // Events each thread can record.
+
+struct timeline_event {
+	const char* name;
+	int64_t start;               // Nanoseconds since timeline_start.
+	int64_t duration;            // -1 for a counter.
+	const char* const* series;   // Counters only.
+	int count;
+	float values[TIMELINE_COUNTER_VALUES];
+};
+
+// One thread's events. Only that thread writes to it. Events up to count are
+// finished and never change again, so they can be read without a lock.
+struct timeline_buffer {
+	int id;
+	atomic<const char*> name;
+	timeline_event* events;
+	atomic<size_t> count;
+	atomic<size_t> dropped;
+};
+
+const chrono::steady_clock::time_point timeline_start = chrono::steady_clock::now();
+mutex timeline_mutex;                      // Guards timeline_buffers and writing the file.
+vector<timeline_buffer*> timeline_buffers;  // Kept after their thread ends.
+thread_local timeline_buffer* thread_buffer = NULL;
+string timeline_file;
+std::atomic<bool> timeline_write_requested(false);
+
+timeline_buffer& local_buffer();  // The calling thread's buffer, made on first use.
+timeline_event* next_event();     // NULL if the buffer is full.
+
+timeline_scope::timeline_scope(const char* name) : name(name), start(timeline_now()) {}
+
+timeline_scope::~timeline_scope() {
+	int64_t end = timeline_now();
+	timeline_event* event = next_event();
+	if (event) {
+		event->name = name;
+		event->start = start;
+		event->duration = end - start;
+		local_buffer().count.fetch_add(1, memory_order_release);
+	}
+}
+
+int64_t timeline_now() {
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - timeline_start).count();
+}
+
+void timeline_thread_name(const char* name) {
+	local_buffer().name = name;
+}
+
+void timeline_counter(const char* name, const char* const* series, const double* values, int count) {
+	timeline_event* event = next_event();
+	if (event == NULL) {
+		return;
+	}
+	event->name = name;
+	event->start = timeline_now();
+	event->duration = -1;
+	event->series = series;
+	event->count = count < TIMELINE_COUNTER_VALUES ? count : TIMELINE_COUNTER_VALUES;
+	for (int i = 0; i < event->count; i++) {
+		event->values[i] = (float)values[i];
+	}
+	local_buffer().count.fetch_add(1, memory_order_release);
+}
+
+void set_timeline_output(const char* filename) {
+	timeline_file = filename;
+}
+
+void write_timeline() {
+	if (timeline_file.empty()) {
+		return;
+	}
+	lock_guard<mutex> lock(timeline_mutex);
+	FILE* file = fopen(timeline_file.c_str(), "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", timeline_file.c_str());
+		return;
+	}
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"emu\"}}");
+	size_t dropped = 0;
+	for (size_t i = 0; i < timeline_buffers.size(); i++) {
+		timeline_buffer& buffer = *timeline_buffers[i];
+		const char* name = buffer.name;
+		if (name) {
+			fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", buffer.id, name);
+		}
+
+		size_t count = buffer.count.load(memory_order_acquire);
+		for (size_t j = 0; j < count; j++) {
+			const timeline_event& event = buffer.events[j];
+			if (event.duration >= 0) {
+				fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+					event.name, buffer.id, event.start / 1000.0, event.duration / 1000.0);
+				continue;
+			}
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{",
+				event.name, buffer.id, event.start / 1000.0);
+			for (int k = 0; k < event.count; k++) {
+				fprintf(file, "%s\"%s\":%.3f", k ? "," : "", event.series[k], event.values[k]);
+			}
+			fprintf(file, "}}");
+		}
+		dropped += buffer.dropped;
+	}
+	fprintf(file, "\n]}\n");
+	fclose(file);
+
+	if (dropped) {
+		fprintf(stderr, "Timeline: %llu events did not fit and were dropped\n", (unsigned long long)dropped);
+	}
+}
+
+timeline_buffer& local_buffer() {
+	if (thread_buffer == NULL) {
+		thread_buffer = new timeline_buffer();
+		thread_buffer->name = NULL;
+		thread_buffer->events = new timeline_event[TIMELINE_EVENTS];
+		thread_buffer->count = 0;
+		thread_buffer->dropped = 0;
+
+		lock_guard<mutex> lock(timeline_mutex);
+		thread_buffer->id = (int)timeline_buffers.size() + 1;
+		timeline_buffers.push_back(thread_buffer);
+	}
+	return *thread_buffer;
+}
+
+timeline_event* next_event() {
+	timeline_buffer& buffer = local_buffer();
+	size_t count = buffer.count.load(memory_order_relaxed);
+	if (count >= TIMELINE_EVENTS) {
+		buffer.dropped++;
+		return NULL;
+	}
+	return &buffer.events[count];
+}
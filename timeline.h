@@ -0,0 +1,58 @@
+// Timeline of what each thread spends its time on, written as Chrome trace
+// event JSON for chrome://tracing, Perfetto and speedscope. Building with
+// TIMELINE (see CMakeLists.txt) turns TIMELINE_SCOPE(name) into a timer that
+// records the block it is in. Without TIMELINE the macros are empty and
+// there is no timing code anywhere.
+//
+// Each thread records into its own buffer, so threads never wait on each
+// other for it, and a buffer that is full drops what comes after. The
+// buffers can be written out at any time, from any thread, while the others
+// go on recording.
+//
+// The core's per instruction work (CPU, timers, PPU and interupts) is far
+// too fine to time one instruction at a time. With --subsystems each frame
+// also gets a counter with the share of the frame each of them took.
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+#ifdef TIMELINE
+#define TIMELINE_JOIN2(a, b) a##b
+#define TIMELINE_JOIN(a, b) TIMELINE_JOIN2(a, b)
+#define TIMELINE_SCOPE(name) timeline_scope TIMELINE_JOIN(timeline_scope_, __LINE__)(name)
+#define TIMELINE_THREAD(name) timeline_thread_name(name)
+#define TIMELINE_COUNTER(name, series, values, count) timeline_counter(name, series, values, count)
+#else
+#define TIMELINE_SCOPE(name)
+#define TIMELINE_THREAD(name)
+#define TIMELINE_COUNTER(name, series, values, count)
+#endif
+
+const int TIMELINE_COUNTER_VALUES = 8;  // Most series a counter can have.
+
+// Times from construction to destruction. name has to outlive the timeline,
+// a string literal.
+struct timeline_scope {
+	const char* name;
+	int64_t start;
+	explicit timeline_scope(const char* name);
+	~timeline_scope();
+};
+
+int64_t timeline_now();                       // Nanoseconds since the timeline started.
+void timeline_thread_name(const char* name);  // Names the calling thread's track.
+
+// Records values for each of series at this point in time, drawn as a
+// stacked chart. Only the first TIMELINE_COUNTER_VALUES are kept.
+void timeline_counter(const char* name, const char* const* series, const double* values, int count);
+
+// Where write_timeline() writes to. Call before starting the core.
+void set_timeline_output(const char* filename);
+
+// Writes everything recorded so far, if there is an output. Can run on any
+// thread at any time.
+void write_timeline();
+
+extern std::atomic<bool> timeline_write_requested;  // Set by the front end to have the core write the timeline after the frame.
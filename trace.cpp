@@ -0,0 +1,125 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+
+#include "trace.h"
+
+using namespace std;
+
+bool trace_enabled = false;
+trace_header* trace = NULL;
+trace_record* trace_records = NULL;
+uint64_t trace_last_cycle = 0;
+
+string trace_file;
+bool trace_mapped = false;
+uint64_t trace_bytes = 0;  // Header and records.
+
+#ifdef _WIN32
+HANDLE trace_mapping = NULL;
+#endif
+
+void* map_trace_file(const char* filename, uint64_t size);  // Creates filename at size bytes and maps it, NULL on failure.
+void unmap_trace_file();
+
+void start_trace(uint64_t records, const char* filename, bool mapped) {
+	uint64_t capacity = 1;
+	while (capacity < records) {
+		capacity <<= 1;
+	}
+	trace_file = filename;
+	trace_mapped = mapped;
+	trace_bytes = sizeof(trace_header) + capacity * sizeof(trace_record);
+
+	void* ring = mapped ? map_trace_file(filename, trace_bytes) : calloc(1, (size_t)trace_bytes);
+	if (ring == NULL) {
+		fprintf(stderr, "Could not set up a trace of %llu records in %s\n", (unsigned long long)capacity, mapped ? filename : "memory");
+		exit(1);
+	}
+
+	trace = (trace_header*)ring;
+	memcpy(trace->magic, TRACE_MAGIC, sizeof(trace->magic));
+	trace->record_size = sizeof(trace_record);
+	trace->reserved = 0;
+	trace->capacity = capacity;
+	trace->written = 0;
+	trace_records = (trace_record*)(trace + 1);
+	trace_last_cycle = 0;
+	trace_enabled = true;
+}
+
+void stop_trace() {
+	if (!trace_enabled) {
+		return;
+	}
+	trace_enabled = false;
+
+	if (trace_mapped) {
+		unmap_trace_file();
+	}
+	else {
+		// Only as much of the ring as was written, so short runs make small
+		// files. gbtrace reads the capacity from the file size then.
+		uint64_t records = trace->written < trace->capacity ? trace->written : trace->capacity;
+		FILE* file = fopen(trace_file.c_str(), "wb");
+		if (file == NULL || fwrite(trace, 1, (size_t)(sizeof(trace_header) + records * sizeof(trace_record)), file) == 0) {
+			fprintf(stderr, "Could not write %s\n", trace_file.c_str());
+		}
+		if (file) {
+			fclose(file);
+		}
+		free(trace);
+	}
+	trace = NULL;
+	trace_records = NULL;
+}
+
+#ifdef _WIN32
+void* map_trace_file(const char* filename, uint64_t size) {
+	HANDLE file = CreateFileA(filename, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return NULL;
+	}
+	trace_mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, NULL);
+	CloseHandle(file);
+	if (trace_mapping == NULL) {
+		return NULL;
+	}
+	return MapViewOfFile(trace_mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)size);
+}
+
+void unmap_trace_file() {
+	FlushViewOfFile(trace, 0);
+	UnmapViewOfFile(trace);
+	CloseHandle(trace_mapping);
+}
+#else
+void* map_trace_file(const char* filename, uint64_t size) {
+	int file = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (file < 0) {
+		return NULL;
+	}
+	if (ftruncate(file, (off_t)size) != 0) {
+		close(file);
+		return NULL;
+	}
+	void* ring = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	close(file);
+	return ring == MAP_FAILED ? NULL : ring;
+}
+
+void unmap_trace_file() {
+	munmap(trace, (size_t)trace_bytes);
+}
+#endif
@@ -0,0 +1,56 @@
+// Execution trace. With trace_enabled cpu_cycle() writes a 16 byte record of
+// the CPU state before every instruction into a ring, so the last
+// instructions before a crash or a wrong frame can be looked at with gbtrace.
+// While it is off the core only pays for testing trace_enabled.
+//
+// The ring either lives in memory and is written to its file when the core
+// stops, or is the file itself mapped into memory, which keeps what was
+// traced even if the process dies. Either way the file is a trace_header
+// followed by capacity records, the newest at (written - 1) % capacity.
+#pragma once
+
+#include <stdint.h>
+
+#define TRACE_MAGIC "GBTRACE1"
+
+struct trace_record {
+	uint16_t pc;
+	uint8_t bank;    // ROM bank of pc, 0xFF in the boot rom.
+	uint8_t opcode;
+	uint8_t a, f, b, c, d, e, h, l;
+	uint16_t sp;
+	uint16_t cycles;  // Since the previous record, 0xFFFF if more.
+};
+static_assert(sizeof(trace_record) == 16, "trace records are 16 bytes");
+
+struct trace_header {
+	char magic[8];         // TRACE_MAGIC.
+	uint32_t record_size;  // sizeof(trace_record).
+	uint32_t reserved;
+	uint64_t capacity;     // Records in the ring, a power of two.
+	uint64_t written;      // Records written in all.
+};
+static_assert(sizeof(trace_header) == 32, "trace header is 32 bytes");
+
+extern bool trace_enabled;             // Set by start_trace().
+extern trace_header* trace;
+extern trace_record* trace_records;
+extern uint64_t trace_last_cycle;      // Emulated cycle of the newest record.
+
+// Starts tracing into a ring of at least records records. The ring is kept
+// in memory and written to filename by stop_trace(), or with mapped the ring
+// is filename. Exits if it cannot be set up. Call before starting the core.
+void start_trace(uint64_t records, const char* filename, bool mapped);
+
+// Writes the ring out or unmaps it. Call after the core has stopped.
+void stop_trace();
+
+// The record to fill in for the next instruction, which runs at emulated
+// cycle now.
+inline trace_record& next_trace_record(uint64_t now) {
+	trace_record& record = trace_records[trace->written++ & (trace->capacity - 1)];
+	uint64_t cycles = now - trace_last_cycle;
+	record.cycles = cycles < 0xFFFF ? (uint16_t)cycles : 0xFFFF;
+	trace_last_cycle = now;
+	return record;
+}
@@ -0,0 +1,202 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "gameboy.h"
+#include "spsc_queue.h"
+#include "wav.h"
+
+using namespace std;
+
+const int WAV_CHUNK_SAMPLES = 1024;       // More than a frame of samples.
+const size_t WAV_CHUNKS = 64;             // Chunks the ring can hold (one slot is kept free).
+const size_t WAV_WRITE_BUFFER = 1 << 20;  // stdio buffer for the output, so writes go out in large blocks.
+
+// One frame of samples.
+struct wav_chunk {
+	uint64_t position;  // Index of the first sample in the recording.
+	int count;
+	audio_sample samples[WAV_CHUNK_SAMPLES];
+};
+
+bool wav_enabled = false;
+
+SpscQueue<wav_chunk, WAV_CHUNKS> wav_ring;  // Filled by end_apu_frame(), drained by the writer.
+wav_chunk wav_in;                           // Chunk being queued. Core thread only.
+uint64_t wav_position = 0;                  // Samples queued or dropped so far. Core thread only.
+wav_chunk wav_out;                          // Chunk being written. Writer thread only.
+float wav_floats[WAV_CHUNK_SAMPLES * 2];    // Converted chunk. Writer thread only.
+wav_format wav_type;
+FILE* wav_file = NULL;
+std::atomic<bool> wav_running(false);
+thread wav_writer;
+
+uint64_t samples_written = 0;  // Written by the writer thread, includes silence.
+uint64_t samples_filled = 0;   // Silence written in place of dropped chunks.
+uint64_t chunks_dropped = 0;   // Written by the core thread.
+
+void wav_loop();                               // Writer thread body.
+void write_wav_chunk(const wav_chunk& chunk);  // Fills any gap before the chunk and writes it out.
+void write_silence(uint64_t count);
+void write_wav_header();                       // Writes the header for samples_written samples.
+
+void start_wav(const char* filename, wav_format format) {
+	wav_file = fopen(filename, "wb");
+	if (wav_file == NULL) {
+		cerr << "Could not open WAV output " << filename << endl;
+		exit(1);
+	}
+	setvbuf(wav_file, NULL, _IOFBF, WAV_WRITE_BUFFER);
+
+	// Placeholder sizes, filled in by stop_wav().
+	wav_type = format;
+	write_wav_header();
+
+	wav_enabled = true;
+	wav_running = true;
+	wav_writer = thread(wav_loop);
+}
+
+void wav_samples(const audio_sample* samples, int count) {
+	if (count > WAV_CHUNK_SAMPLES) {
+		count = WAV_CHUNK_SAMPLES;
+	}
+	wav_in.position = wav_position;
+	wav_in.count = count;
+	wav_position += count;
+	memcpy(wav_in.samples, samples, count * sizeof(audio_sample));
+
+	if (!wav_ring.push(wav_in)) {
+		chunks_dropped++;
+	}
+}
+
+void stop_wav() {
+	if (!wav_enabled) {
+		return;
+	}
+
+	wav_running = false;
+	wav_writer.join();
+
+	// Chunks dropped at the very end have no later chunk to show the gap.
+	if (wav_position > samples_written) {
+		samples_filled += wav_position - samples_written;
+		write_silence(wav_position - samples_written);
+	}
+
+	fflush(wav_file);
+	fseek(wav_file, 0, SEEK_SET);
+	write_wav_header();
+	fclose(wav_file);
+	wav_enabled = false;
+
+	cout << "Wrote " << samples_written << " samples, dropped " << chunks_dropped << " frames, filled "
+		<< samples_filled << " samples with silence" << endl;
+}
+
+void wav_loop() {
+	while (true) {
+		if (wav_ring.pop(wav_out)) {
+			write_wav_chunk(wav_out);
+			continue;
+		}
+
+		// Anything queued before the stop is still written out.
+		if (!wav_running) {
+			while (wav_ring.pop(wav_out)) {
+				write_wav_chunk(wav_out);
+			}
+			break;
+		}
+		this_thread::sleep_for(chrono::milliseconds(1));
+	}
+}
+
+void write_wav_chunk(const wav_chunk& chunk) {
+	// Counted in samples as the APU made them, so a gap is exactly the
+	// chunks dropped before this one whatever rate they were made at.
+	if (chunk.position > samples_written) {
+		samples_filled += chunk.position - samples_written;
+		write_silence(chunk.position - samples_written);
+	}
+
+	if (wav_type == WAV_FLOAT) {
+		for (int i = 0; i < chunk.count; i++) {
+			wav_floats[i * 2] = chunk.samples[i].left / 32768.0f;
+			wav_floats[i * 2 + 1] = chunk.samples[i].right / 32768.0f;
+		}
+		fwrite(wav_floats, sizeof(float) * 2, chunk.count, wav_file);
+	}
+	else {
+		fwrite(chunk.samples, sizeof(audio_sample), chunk.count, wav_file);
+	}
+	samples_written += chunk.count;
+}
+
+void write_silence(uint64_t count) {
+	memset(wav_floats, 0, sizeof(wav_floats));
+	size_t sample_size = wav_type == WAV_FLOAT ? sizeof(float) * 2 : sizeof(audio_sample);
+	while (count > 0) {
+		size_t block = count < WAV_CHUNK_SAMPLES ? (size_t)count : WAV_CHUNK_SAMPLES;
+		fwrite(wav_floats, sample_size, block, wav_file);
+		samples_written += block;
+		count -= block;
+	}
+}
+
+// Little endian RIFF header. Float files get the extended format chunk and
+// the fact chunk that non-PCM formats need.
+void write_wav_header() {
+	bool is_float = wav_type == WAV_FLOAT;
+	uint32_t sample_size = is_float ? 8 : 4;
+	uint32_t format_size = is_float ? 18 : 16;
+	uint64_t data_size = samples_written * sample_size;
+	if (data_size > 0xFFFFFFFF - 64) {
+		data_size = 0xFFFFFFFF - 64;
+	}
+
+	uint8_t header[64];
+	uint8_t* p = header;
+	auto put = [&p](uint32_t value, int bytes) {
+		for (int i = 0; i < bytes; i++) {
+			*p++ = (uint8_t)(value >> (i * 8));
+		}
+	};
+	auto tag = [&p](const char* name) {
+		memcpy(p, name, 4);
+		p += 4;
+	};
+
+	uint32_t header_size = 12 + 8 + format_size + (is_float ? 12 : 0) + 8;
+	tag("RIFF");
+	put(header_size - 8 + (uint32_t)data_size, 4);
+	tag("WAVE");
+
+	tag("fmt ");
+	put(format_size, 4);
+	put(is_float ? 3 : 1, 2);  // WAVE_FORMAT_IEEE_FLOAT or WAVE_FORMAT_PCM
+	put(2, 2);
+	put(AUDIO_SAMPLE_RATE, 4);
+	put(AUDIO_SAMPLE_RATE * sample_size, 4);
+	put(sample_size, 2);
+	put(is_float ? 32 : 16, 2);  // Bits per channel.
+	if (is_float) {
+		put(0, 2);
+
+		tag("fact");
+		put(4, 4);
+		put((uint32_t)(data_size / sample_size), 4);
+	}
+
+	tag("data");
+	put((uint32_t)data_size, 4);
+
+	fwrite(header, 1, p - header, wav_file);
+}
@@ -0,0 +1,27 @@
+// WAV recording. At the end of each frame the APU hands its samples over
+// and a writer thread converts and writes them, so recording never makes the
+// emulation wait. Chunks that find the ring full are dropped and counted,
+// and the gaps they leave are written as silence so the file stays on the
+// emulated timeline and in step with a video capture of the same run.
+#pragma once
+
+#include <stdint.h>
+
+#include "gameboy.h"
+
+enum wav_format {
+	WAV_PCM16,
+	WAV_FLOAT,
+};
+
+extern bool wav_enabled;  // Set by start_wav().
+
+// Creates filename and starts the writer thread. Call before starting the core.
+void start_wav(const char* filename, wav_format format);
+
+// Queues one frame of samples. Called by end_apu_frame().
+void wav_samples(const audio_sample* samples, int count);
+
+// Writes out the queued samples, fills in the header and reports how many
+// samples were written and dropped. Call after the core has stopped.
+void stop_wav();